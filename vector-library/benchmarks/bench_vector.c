@@ -0,0 +1,340 @@
+#define _POSIX_C_SOURCE 200809L  // clock_gettime()
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "vector_int.h"
+#include "vector_simd.h"
+
+/*
+ * bench_vector - Microbenchmarks for the IntVector operations
+ *
+ * Each operation runs on vectors of several sizes:
+ * - push, pop: one element, ns/op averaged over filling/draining n
+ * - insert, remove: one element in the middle of a vector of n
+ * - find: a value that is not there (a full scan of n)
+ * - copy, extend: a whole vector of n
+ *
+ * Each call leaves the vector as it found it, so a round repeats calls on
+ * one vector until it takes at least MIN_ROUND_SECONDS; times are the best
+ * of RUNS rounds. Allocations per operation come from a separate, untimed
+ * call with a counting allocator. With --baseline=FILE each ns/op
+ * is compared against a file written earlier with --save=FILE.
+ */
+
+#define RUNS 3
+#define MIN_ROUND_SECONDS 0.02
+#define NOISE_PERCENT 5.0           // Smaller changes are reported as "~"
+#define MAX_MIDDLE_OPS 1000         // insert/remove rounds on large vectors stay short
+
+static const size_t sizes[] = {16, 1024, 65536, 1048576};
+#define NSIZES (sizeof(sizes) / sizeof(sizes[0]))
+
+struct result {
+    char name[32];
+    size_t size;
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+
+// Allocation counting (only in the untimed round)
+static size_t allocations;
+
+static void *counting_alloc(void *ctx, size_t size) {
+    (void)ctx;
+    allocations++;
+    return malloc(size);
+}
+
+static void *counting_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+    (void)ctx;
+    (void)old_size;
+    allocations++;
+    return realloc(ptr, new_size);
+}
+
+static void counting_free(void *ctx, void *ptr, size_t size) {
+    (void)ctx;
+    (void)size;
+    free(ptr);
+}
+
+static const VectorAllocator counting = {counting_alloc, counting_realloc, counting_free, NULL};
+
+
+// Operations: each call performs ops(n) operations and leaves vec (of n elements) as it found it
+static volatile long long sink;  // Keeps results (and so the work) alive
+static int scratch[MAX_MIDDLE_OPS];  // Values to put back after remove
+
+static size_t ops_all(size_t n) {
+    return n;
+}
+
+static size_t ops_middle(size_t n) {
+    return n < MAX_MIDDLE_OPS ? n : MAX_MIDDLE_OPS;
+}
+
+static size_t ops_one(size_t n) {
+    (void)n;
+    return 1;
+}
+
+static void run_push(IntVector *vec, size_t n, const VectorAllocator *allocator) {
+    (void)vec;
+    IntVector *fresh = int_vector_create_with(0, allocator);
+    for (size_t i = 0; i < n; i++) {
+        int_vector_push(fresh, (int)i);
+    }
+    sink += int_vector_size(fresh);
+    int_vector_destroy(fresh);
+}
+
+/* Drains vec, then refills it with one append (a memcpy, small next to n pops) */
+static void run_pop(IntVector *vec, size_t n, const VectorAllocator *allocator) {
+    (void)allocator;
+    static int *saved;
+    static size_t saved_size;
+    if (saved_size < n) {
+        free(saved);
+        saved = malloc(n * sizeof(int));
+        saved_size = n;
+    }
+    long long sum = 0;
+    for (size_t i = n; i > 0; i--) {
+        int value = int_vector_pop(vec);
+        saved[i - 1] = value;
+        sum += value;
+    }
+    int_vector_append(vec, saved, n);
+    sink += sum;
+}
+
+/* Inserts in the middle; one remove_range puts vec back */
+static void run_insert(IntVector *vec, size_t n, const VectorAllocator *allocator) {
+    (void)allocator;
+    size_t k = ops_middle(n);
+    for (size_t i = 0; i < k; i++) {
+        int_vector_insert(vec, n / 2, (int)i);
+    }
+    int_vector_remove_range(vec, n / 2, k);
+}
+
+/* Removes from the middle; one insert_range puts the values back */
+static void run_remove(IntVector *vec, size_t n, const VectorAllocator *allocator) {
+    (void)allocator;
+    size_t k = ops_middle(n);
+    size_t first = (n - k) / 2;
+    for (size_t i = 0; i < k; i++) {
+        int_vector_remove(vec, first);
+    }
+    for (size_t i = 0; i < k; i++) {
+        scratch[i] = (int)(first + i);
+    }
+    int_vector_insert_range(vec, first, scratch, k);
+}
+
+static void run_find(IntVector *vec, size_t n, const VectorAllocator *allocator) {
+    (void)n;
+    (void)allocator;
+    sink += int_vector_find(vec, -1);
+}
+
+static void run_copy(IntVector *vec, size_t n, const VectorAllocator *allocator) {
+    (void)n;
+    (void)allocator;
+    IntVector *copy = int_vector_copy(vec);
+    sink += int_vector_size(copy);
+    int_vector_destroy(copy);
+}
+
+static void run_extend(IntVector *vec, size_t n, const VectorAllocator *allocator) {
+    (void)n;
+    IntVector *dest = int_vector_create_with(0, allocator);
+    int_vector_extend(dest, vec);
+    sink += int_vector_size(dest);
+    int_vector_destroy(dest);
+}
+
+struct benchmark {
+    const char *name;
+    void (*run)(IntVector *vec, size_t n, const VectorAllocator *allocator);
+    size_t (*ops)(size_t n);
+};
+
+static const struct benchmark benchmarks[] = {
+    {"push", run_push, ops_all},
+    {"pop", run_pop, ops_all},
+    {"insert", run_insert, ops_middle},
+    {"remove", run_remove, ops_middle},
+    {"find", run_find, ops_one},
+    {"copy", run_copy, ops_one},
+    {"extend", run_extend, ops_one},
+};
+#define NBENCHMARKS (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+/* 0, 1, ..., n - 1 */
+static IntVector *filled(size_t n, const VectorAllocator *allocator) {
+    IntVector *vec = int_vector_create_with(n, allocator);
+    for (size_t i = 0; i < n; i++) {
+        int_vector_push(vec, (int)i);
+    }
+    return vec;
+}
+
+
+// Timing
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Seconds per call, best of RUNS rounds */
+static double time_call(const struct benchmark *b, size_t n) {
+    IntVector *vec = filled(n, NULL);
+    double best = 1e30;
+    for (int run = 0; run < RUNS; run++) {
+        size_t calls = 0;
+        double start = now_seconds();
+        double elapsed;
+        do {
+            b->run(vec, n, NULL);
+            calls++;
+            elapsed = now_seconds() - start;
+        } while (elapsed < MIN_ROUND_SECONDS);
+        if (elapsed / calls < best) best = elapsed / calls;
+    }
+    int_vector_destroy(vec);
+    return best;
+}
+
+/* Allocations and reallocations made by one call */
+static size_t count_allocations(const struct benchmark *b, size_t n) {
+    IntVector *vec = filled(n, &counting);
+    b->run(vec, n, &counting);  // Warm-up: the first pop may still reserve room for the refill
+    allocations = 0;
+    b->run(vec, n, &counting);
+    size_t count = allocations;
+    int_vector_destroy(vec);
+    return count;
+}
+
+static void bench(const struct benchmark *b, size_t n, struct result *r) {
+    snprintf(r->name, sizeof(r->name), "%s", b->name);
+    r->size = n;
+    r->ns_per_op = time_call(b, n) * 1e9 / b->ops(n);
+    r->allocs_per_op = (double)count_allocations(b, n) / b->ops(n);
+}
+
+
+// Baseline files: one "name size ns_per_op allocs_per_op" line per result
+static int save_baseline(const char *path, const struct result *results, size_t count) {
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) {
+        fprintf(stderr, "bench_vector: cannot write '%s': %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    fprintf(fp, "# bench_vector baseline (SIMD: %s)\n", vector_simd_name());
+    for (size_t i = 0; i < count; i++) {
+        fprintf(fp, "%s %zu %.3f %.6f\n", results[i].name, results[i].size,
+                results[i].ns_per_op, results[i].allocs_per_op);
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+static size_t load_baseline(const char *path, struct result *baseline, size_t max) {
+    FILE *fp = fopen(path, "r");
+    char line[256];
+    size_t count = 0;
+
+    if (fp == NULL) return 0;
+    while (count < max && fgets(line, sizeof(line), fp) != NULL) {
+        struct result *b = &baseline[count];
+        if (line[0] != '#' && sscanf(line, "%31s %zu %lf %lf", b->name, &b->size,
+                                     &b->ns_per_op, &b->allocs_per_op) == 4) {
+            count++;
+        }
+    }
+    fclose(fp);
+    return count;
+}
+
+/* Change of ns/op: negative is faster */
+static void print_change(double now, double before) {
+    double percent = before > 0 ? (now - before) / before * 100.0 : 0;
+
+    if (before <= 0) {
+        printf("  %8s", "-");
+    } else if (percent > -NOISE_PERCENT && percent < NOISE_PERCENT) {
+        printf("  %7s~", "");
+    } else {
+        printf("  %+7.1f%%", percent);
+    }
+}
+
+
+static void usage(const char *prog_name) {
+    fprintf(stderr, "Usage: %s [--only=NAME] [--baseline=FILE] [--save=FILE]\n", prog_name);
+}
+
+int main(int argc, char *argv[]) {
+    const char *only = NULL;
+    const char *baseline_path = NULL;
+    const char *save_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--only=", 7) == 0) {
+            only = argv[i] + 7;
+        } else if (strncmp(argv[i], "--baseline=", 11) == 0) {
+            baseline_path = argv[i] + 11;
+        } else if (strncmp(argv[i], "--save=", 7) == 0) {
+            save_path = argv[i] + 7;
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct result results[NBENCHMARKS * NSIZES];
+    struct result baseline[NBENCHMARKS * NSIZES];
+    size_t nresults = 0;
+    size_t nbaseline = baseline_path != NULL ? load_baseline(baseline_path, baseline, NBENCHMARKS * NSIZES) : 0;
+
+    printf("bench_vector: best of %d rounds, SIMD %s\n", RUNS, vector_simd_name());
+    if (baseline_path != NULL && nbaseline == 0) {
+        printf("No baseline in '%s' yet (make bench-save writes one)\n", baseline_path);
+    }
+    printf("\n%-8s  %8s  %12s  %10s", "op", "n", "ns/op", "allocs/op");
+    if (nbaseline > 0) printf("  %9s", "vs base");
+    printf("\n");
+
+    for (size_t b = 0; b < NBENCHMARKS; b++) {
+        if (only != NULL && strcmp(only, benchmarks[b].name) != 0) continue;
+        for (size_t s = 0; s < NSIZES; s++) {
+            struct result *r = &results[nresults++];
+            bench(&benchmarks[b], sizes[s], r);
+
+            printf("%-8s  %8zu  %12.2f  %10.4f", r->name, r->size, r->ns_per_op, r->allocs_per_op);
+            for (size_t i = 0; i < nbaseline; i++) {
+                if (strcmp(baseline[i].name, r->name) == 0 && baseline[i].size == r->size) {
+                    print_change(r->ns_per_op, baseline[i].ns_per_op);
+                }
+            }
+            printf("\n");
+            fflush(stdout);
+        }
+    }
+
+    int status = EXIT_SUCCESS;
+    if (save_path != NULL) {
+        if (save_baseline(save_path, results, nresults) == 0) {
+            printf("\nBaseline saved to '%s'\n", save_path);
+        } else {
+            status = EXIT_FAILURE;
+        }
+    }
+    return status;
+}
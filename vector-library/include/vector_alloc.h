@@ -0,0 +1,128 @@
+#ifndef VECTOR_ALLOC_H
+#define VECTOR_ALLOC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * VectorAllocator - Pluggable memory for vectors
+ *
+ * A vector created with int_vector_create_with() (or prefix_create_with()
+ * for generated vectors) takes its struct and its data from the allocator
+ * instead of malloc/realloc/free. The vector keeps a pointer to the
+ * allocator, which must outlive it.
+ *
+ * Sizes are passed back on realloc and free, so an allocator does not
+ * have to track them; realloc and free are never called with NULL.
+ * VectorArena is a bundled bump allocator: thousands of short-lived
+ * vectors are released together by one vector_arena_reset().
+ *
+ * Without an allocator, blocks of VECTOR_PAGE_THRESHOLD bytes or more are
+ * mapped pages instead of malloc memory (see vector_pages_alloc below).
+ */
+
+typedef struct VectorAllocator {
+    void *(*alloc)(void *ctx, size_t size);                                 // NULL on failure
+    void *(*realloc)(void *ctx, void *ptr, size_t old_size, size_t new_size); // NULL on failure (ptr stays valid)
+    void (*free)(void *ctx, void *ptr, size_t size);
+    void *ctx;
+} VectorAllocator;
+
+/*
+ * Large blocks - page-aligned mappings for multi-megabyte vectors
+ *
+ * Growing one of these uses mremap (Linux), which moves page table
+ * entries instead of copying the data, and they are marked for
+ * transparent huge pages. A block is a mapping exactly when its size is
+ * at least VECTOR_PAGE_THRESHOLD, so the size passed back on realloc and
+ * free is all it takes to tell the two kinds apart.
+ */
+#define VECTOR_PAGE_THRESHOLD ((size_t)32 << 20)  // 32 MiB
+
+void *vector_pages_alloc(size_t size);                                      // Mapped block of size bytes (NULL on failure)
+void *vector_pages_realloc(void *ptr, size_t old_size, size_t new_size);    // Resize, moving between malloc and a mapping across the threshold
+void vector_pages_free(void *ptr, size_t size);                             // Unmap (or free() below the threshold)
+void vector_pages_set_huge(bool enabled);                                   // Ask for transparent huge pages on new mappings (default on; set before use)
+bool vector_pages_remaps(size_t old_size, size_t new_size);                 // True if a resize between these sizes moves pages (mremap) instead of copying
+
+// Used by the vector implementation: a NULL allocator means the C library
+static inline void *vector_mem_alloc(const VectorAllocator *a, size_t size) {
+    if (a) return a->alloc(a->ctx, size);
+    return size >= VECTOR_PAGE_THRESHOLD ? vector_pages_alloc(size) : malloc(size);
+}
+
+static inline void *vector_mem_realloc(const VectorAllocator *a, void *ptr, size_t old_size, size_t new_size) {
+    if (!a) {
+        if (ptr && (old_size >= VECTOR_PAGE_THRESHOLD || new_size >= VECTOR_PAGE_THRESHOLD)) {
+            return vector_pages_realloc(ptr, old_size, new_size);
+        }
+        return ptr ? realloc(ptr, new_size) : vector_mem_alloc(NULL, new_size);
+    }
+    return ptr ? a->realloc(a->ctx, ptr, old_size, new_size) : a->alloc(a->ctx, new_size);
+}
+
+/* Whether a vector_mem_realloc() that returned a new address copied the contents */
+static inline bool vector_mem_realloc_copies(const VectorAllocator *a, size_t old_size, size_t new_size) {
+    return a != NULL || !vector_pages_remaps(old_size, new_size);
+}
+
+static inline void vector_mem_free(const VectorAllocator *a, void *ptr, size_t size) {
+    if (a) {
+        if (ptr) a->free(a->ctx, ptr, size);
+    } else if (size >= VECTOR_PAGE_THRESHOLD) {
+        vector_pages_free(ptr, size);
+    } else {
+        free(ptr);
+    }
+}
+
+
+/*
+ * Growth policies - how a full vector picks its next capacity
+ *
+ * Doubling (the default) copies each element about once on average but
+ * can leave half the capacity unused. 1.5x wastes at most a third.
+ * Fixed increments waste at most one increment, at the cost of O(n)
+ * resizes in total (cheap for mapped blocks, which mremap never copies).
+ */
+typedef enum VectorGrowth {
+    VECTOR_GROWTH_DOUBLE,       // capacity * 2
+    VECTOR_GROWTH_HALF,         // capacity * 1.5
+    VECTOR_GROWTH_FIXED         // capacity + increment
+} VectorGrowth;
+
+/* Next capacity after capacity that holds at least min_capacity (0 if none fits in size_t) */
+static inline size_t vector_next_capacity(VectorGrowth growth, size_t increment,
+                                          size_t capacity, size_t min_capacity) {
+    size_t cap = capacity;
+    if (growth == VECTOR_GROWTH_FIXED) {
+        size_t steps = (min_capacity - cap + increment - 1) / increment;
+        return steps <= (SIZE_MAX - cap) / increment ? cap + steps * increment : 0;
+    }
+    while (cap < min_capacity) {
+        size_t more = cap < 2 ? 1 : growth == VECTOR_GROWTH_HALF ? cap / 2 : cap;
+        if (more > SIZE_MAX - cap) return 0;
+        cap += more;
+    }
+    return cap;
+}
+
+/*
+ * VectorArena - Bump allocator
+ *
+ * Allocations are carved from large blocks by bumping an offset. free()
+ * and realloc() of the most recent allocation give the space back or grow
+ * it in place; anything else is reclaimed only by reset/destroy. Not
+ * thread-safe: use one arena per thread (or per request).
+ */
+typedef struct VectorArena VectorArena;
+
+VectorArena *vector_arena_create(size_t block_size);            // Create an arena (0 for the default 64 KiB blocks)
+void vector_arena_destroy(VectorArena *arena);                  // Free the arena and everything allocated from it
+void vector_arena_reset(VectorArena *arena);                    // Release every allocation at once, keep the first block for reuse
+size_t vector_arena_used(const VectorArena *arena);             // Bytes handed out since the last reset
+VectorAllocator vector_arena_allocator(VectorArena *arena);     // Allocator that draws from arena
+
+#endif /* VECTOR_ALLOC_H */
@@ -0,0 +1,51 @@
+#ifndef VECTOR_COMPRESSED_H
+#define VECTOR_COMPRESSED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * CompressedIntVector - Read-only, compressed companion to IntVector
+ *
+ * Values are stored in blocks of COMPRESSED_BLOCK_SIZE. Each block keeps
+ * its first value, and every other value as the difference to the value
+ * four places earlier (so four running sums decode in parallel, one SSE2
+ * add per four values), bit-packed at the width of the block's largest
+ * difference. Unsorted input stores the differences zigzag-encoded.
+ * Sorted, dense ID lists shrink to a few bits per value.
+ *
+ * Features:
+ * - Block-wise random access: get() touches a single block
+ * - decode() unpacks whole blocks with SSE2 where available
+ * - On sorted vectors lower_bound/find binary-search the block heads and
+ *   decode one block; unsorted vectors are scanned block by block
+ *
+ * Build one with int_vector_compress() and turn it back with
+ * int_vector_decompress() (vector_int.h), or from a plain array here.
+ */
+
+#define COMPRESSED_BLOCK_SIZE 128
+
+typedef struct CompressedIntVector CompressedIntVector;
+
+// Creation and Destruction
+CompressedIntVector *compressed_int_vector_create(const int *values, size_t count); // Encode count values (NULL on failure)
+void compressed_int_vector_destroy(CompressedIntVector *cv);                        // Free all memory
+
+// Accessors
+size_t compressed_int_vector_size(const CompressedIntVector *cv);                   // Number of values
+size_t compressed_int_vector_bytes(const CompressedIntVector *cv);                  // Memory used, metadata included
+bool compressed_int_vector_is_sorted(const CompressedIntVector *cv);                // Values were in ascending order
+int compressed_int_vector_get(const CompressedIntVector *cv, size_t index);         // Value at index (bounds checked, decodes part of one block)
+
+// Decoding
+size_t compressed_int_vector_blocks(const CompressedIntVector *cv);                 // Number of blocks
+size_t compressed_int_vector_decode_block(const CompressedIntVector *cv, size_t block, int *out); // Write one block's values to out (room for COMPRESSED_BLOCK_SIZE); returns how many
+void compressed_int_vector_decode(const CompressedIntVector *cv, int *out);          // Write all size() values to out
+
+// Search
+int compressed_int_vector_find(const CompressedIntVector *cv, int value);           // First index of value, or -1 (skips blocks when sorted)
+bool compressed_int_vector_contains(const CompressedIntVector *cv, int value);      // Check if value is present
+size_t compressed_int_vector_lower_bound(const CompressedIntVector *cv, int value); // First index with value >= value (must be sorted)
+
+#endif /* VECTOR_COMPRESSED_H */
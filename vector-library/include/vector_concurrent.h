@@ -0,0 +1,39 @@
+#ifndef VECTOR_CONCURRENT_H
+#define VECTOR_CONCURRENT_H
+
+#include <stddef.h>
+#include "vector_int.h"
+
+/*
+ * ConcurrentIntVector - Append-only vector shared between threads
+ *
+ * push/append reserve slots with one atomic fetch-add and never take a
+ * lock. Storage is a list of segments, each twice the size of the one
+ * before, so growth allocates a new segment instead of moving elements:
+ * an element's address never changes, and get() may run concurrently
+ * with appends.
+ *
+ * Every slot is marked once written, and the vector publishes the
+ * longest written prefix: size() and snapshot() see exactly that prefix
+ * and never wait for appends still in flight. Readers who want a plain
+ * IntVector take a snapshot or, once the writers are done, freeze the
+ * vector. Both copy. Needs GCC/Clang atomic builtins.
+ */
+
+typedef struct ConcurrentIntVector ConcurrentIntVector;
+
+// Creation and Destruction (not thread-safe)
+ConcurrentIntVector *concurrent_int_vector_create(void);                      // Create an empty vector (NULL on failure)
+void concurrent_int_vector_destroy(ConcurrentIntVector *cv);                  // Free all memory
+IntVector *concurrent_int_vector_freeze(ConcurrentIntVector *cv);             // Copy every element into a new IntVector, then destroy cv: O(n), briefly 2x memory (writers must be done)
+
+// Appending (thread-safe, lock-free)
+size_t concurrent_int_vector_push(ConcurrentIntVector *cv, int value);        // Append value; returns its index
+size_t concurrent_int_vector_append(ConcurrentIntVector *cv, const int *values, size_t count); // Append count values at consecutive indices; returns the first
+
+// Reading (thread-safe)
+int concurrent_int_vector_get(const ConcurrentIntVector *cv, size_t index);   // Element below size(), or at an index whose append has returned
+size_t concurrent_int_vector_size(const ConcurrentIntVector *cv);             // Length of the written prefix: get(i) is valid for every i below it
+IntVector *concurrent_int_vector_snapshot(const ConcurrentIntVector *cv);     // Copy of the written prefix, without waiting (NULL on failure)
+
+#endif /* VECTOR_CONCURRENT_H */
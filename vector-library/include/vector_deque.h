@@ -0,0 +1,48 @@
+#ifndef VECTOR_DEQUE_H
+#define VECTOR_DEQUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "vector_alloc.h"
+#include "vector_int.h"
+
+/*
+ * IntDeque - A double-ended queue of integers
+ *
+ * A circular buffer whose capacity is a power of two, so an index wraps
+ * with a mask. push/pop at either end are O(1) (amortized when the buffer
+ * grows), where int_vector_insert(vec, 0, x) and int_vector_remove(vec, 0)
+ * shift the whole array. linearize() makes the contents contiguous for
+ * bulk reads; otherwise they may wrap around the end of the buffer.
+ */
+
+typedef struct IntDeque IntDeque;
+
+// Creation and Destruction
+IntDeque *int_deque_create(size_t initial_capacity);            // Create a deque (capacity rounded up to a power of two, 0 for default)
+IntDeque *int_deque_create_with(size_t initial_capacity, const VectorAllocator *allocator); // Same, but all memory comes from allocator (must outlive the deque)
+void int_deque_destroy(IntDeque *dq);                           // Destroy a deque, freeing all memory
+void int_deque_clear(IntDeque *dq);                             // Remove all elements (keeps capacity)
+
+// Basic Operations (O(1), amortized when the buffer grows)
+void int_deque_push_back(IntDeque *dq, int value);              // Append value after the last element
+void int_deque_push_front(IntDeque *dq, int value);             // Prepend value before the first element
+int int_deque_pop_back(IntDeque *dq);                           // Remove and return the last element (not empty)
+int int_deque_pop_front(IntDeque *dq);                          // Remove and return the first element (not empty)
+void int_deque_append(IntDeque *dq, const int *values, size_t count); // Push count ints at the back (at most two memcpys)
+
+// Accessors
+int int_deque_front(const IntDeque *dq);                        // First element (not empty)
+int int_deque_back(const IntDeque *dq);                         // Last element (not empty)
+int int_deque_get(const IntDeque *dq, size_t index);            // Element index positions from the front (bounds checked)
+void int_deque_set(IntDeque *dq, size_t index, int value);      // Set element index positions from the front (bounds checked)
+size_t int_deque_size(const IntDeque *dq);                      // Get current number of elements
+size_t int_deque_capacity(const IntDeque *dq);                  // Get current allocated capacity (a power of two)
+bool int_deque_is_empty(const IntDeque *dq);                    // Check if deque is empty
+
+// Memory Management and Bulk Access
+void int_deque_reserve(IntDeque *dq, size_t new_capacity);      // Ensure deque has at least given capacity
+int *int_deque_linearize(IntDeque *dq);                         // Rotate the elements to the start of the buffer (O(n) only if they wrap); valid until the next push
+IntVector *int_deque_to_vector(const IntDeque *dq);             // Copy into a new IntVector, front first (NULL on failure)
+
+#endif /* VECTOR_DEQUE_H */
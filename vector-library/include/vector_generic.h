@@ -0,0 +1,800 @@
+#ifndef VECTOR_GENERIC_H
+#define VECTOR_GENERIC_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vector_alloc.h"
+#include "vector_simd.h"
+#include "vector_sort.h"
+#include "vector_stats.h"
+
+/*
+ * Generic vector - the IntVector API for any element type
+ *
+ *   VECTOR_DECLARE(DoubleVector, double_vector, double)   // in a header
+ *   VECTOR_DEFINE(DoubleVector, double_vector, double)    // in one .c file
+ *
+ * or, header-only, with every function inlinable into the caller:
+ *
+ *   VECTOR_DEFINE_INLINE(PointVector, point_vector, struct point)
+ *
+ * Each generates the type Name and prefix_create() ... prefix_equals(),
+ * with the same contracts as the int_vector_* functions in vector_int.h.
+ * The _ORDERED variants (VECTOR_DECLARE_ORDERED, VECTOR_DEFINE_ORDERED,
+ * VECTOR_DEFINE_INLINE_ORDERED) are for arithmetic types ordered by <
+ * (no NaN) and add prefix_sort(), binary search, dedup and the sorted set
+ * operations. IntVector itself is VECTOR_DEFINE_ORDERED(IntVector,
+ * int_vector, int).
+ *
+ * Features:
+ * - Elements are stored contiguously as T: no boxing, no void* per element
+ * - Shifts and copies use memmove/memcpy, and the bulk operations
+ *   (push_n, append, insert_range, remove_range, erase_if) check capacity
+ *   once per call, so inserting k elements costs O(n + k), not O(n * k)
+ * - find/contains/equals compare elements bytewise
+ *   (memcmp). That is exact for integers, pointers and structs without
+ *   padding; floating point compares by representation (NaN finds itself,
+ *   -0.0 does not find 0.0)
+ * - For 4-byte types find/contains use the SIMD kernels of vector_simd.h
+ *   (so header-only vectors also link libvector_int.a); equals is one
+ *   memcmp, which the C library already runs with SIMD
+ * - Memory comes from malloc (page mappings from VECTOR_PAGE_THRESHOLD
+ *   bytes up, grown with mremap), or from the VectorAllocator passed to
+ *   prefix_create_with() (see vector_alloc.h); copies share the allocator
+ * - Capacity doubles when full, or grows by 1.5x or a fixed increment
+ *   after prefix_set_growth(); copies keep the policy
+ * - Built with -DVECTOR_STATS, each vector counts its resizes, copies and
+ *   shifts for prefix_stats() (see vector_stats.h); otherwise that code
+ *   is not compiled in
+ * - Small-buffer optimization: up to VECTOR_INLINE_CAPACITY(T) elements
+ *   (64 bytes' worth) live inside the struct, so a short vector costs one
+ *   allocation, and none when it is embedded with prefix_init(). The data
+ *   moves to the heap on overflow and back on shrink_to_fit. The struct
+ *   points into itself: move it only by prefix_copy(), never by assignment
+ * - Ordered vectors remember when they are sorted (prefix_sort() or a
+ *   successful prefix_is_sorted(); any write that may break the order
+ *   forgets it), and find/contains then binary-search in O(log n).
+ *   4-byte integers sort with the O(n) radix sort of vector_sort.h,
+ *   other types with an introsort (quicksort, heapsort past 2 log n
+ *   levels, insertion sort for short ranges)
+ * - VECTOR_DEFINE_INLINE vectors are complete types, so push/get/set
+ *   compile down to a capacity check and an array access
+ */
+
+#define VECTOR_DEFAULT_SIZE 8
+
+/* Bytes of elements stored inside the vector struct itself */
+#ifndef VECTOR_INLINE_BYTES
+#define VECTOR_INLINE_BYTES 64
+#endif
+/* Ordered vectors: insertion sort below this many elements, radix from that */
+#define VECTOR_INSERTION_SORT_MAX 16
+#define VECTOR_RADIX_SORT_MIN 256
+
+#define VECTOR_INLINE_CAPACITY(T)                                                \
+    (VECTOR_INLINE_BYTES / sizeof(T) > 0 ? VECTOR_INLINE_BYTES / sizeof(T) : 1)
+
+
+/* Prototypes for a vector defined with VECTOR_DEFINE in another file */
+#define VECTOR_DECLARE(Name, prefix, T)                                          \
+    typedef struct Name Name;                                                    \
+    Name *prefix##_create(size_t initial_capacity);                              \
+    Name *prefix##_create_with(size_t initial_capacity,                          \
+                               const VectorAllocator *allocator);                \
+    void prefix##_destroy(Name *vec);                                            \
+    Name *prefix##_init(Name *vec, const VectorAllocator *allocator);            \
+    void prefix##_release(Name *vec);                                            \
+    void prefix##_clear(Name *vec);                                              \
+    void prefix##_push(Name *vec, T value);                                      \
+    T prefix##_pop(Name *vec);                                                   \
+    void prefix##_insert(Name *vec, size_t index, T value);                      \
+    void prefix##_remove(Name *vec, size_t index);                               \
+    void prefix##_push_n(Name *vec, T value, size_t count);                      \
+    void prefix##_append(Name *vec, const T *values, size_t count);              \
+    void prefix##_insert_range(Name *vec, size_t index, const T *values,         \
+                               size_t count);                                    \
+    void prefix##_remove_range(Name *vec, size_t index, size_t count);           \
+    size_t prefix##_erase_if(Name *vec, bool (*pred)(T value, void *ctx),        \
+                             void *ctx);                                         \
+    T prefix##_get(const Name *vec, size_t index);                               \
+    void prefix##_set(Name *vec, size_t index, T value);                         \
+    size_t prefix##_size(const Name *vec);                                       \
+    size_t prefix##_capacity(const Name *vec);                                   \
+    bool prefix##_is_empty(const Name *vec);                                     \
+    bool prefix##_is_full(const Name *vec);                                      \
+    void prefix##_reserve(Name *vec, size_t new_capacity);                       \
+    void prefix##_shrink_to_fit(Name *vec);                                      \
+    void prefix##_set_growth(Name *vec, VectorGrowth growth, size_t increment);  \
+    void prefix##_stats(const Name *vec, VectorStats *out);                      \
+    int prefix##_find(const Name *vec, T value);                                 \
+    bool prefix##_contains(const Name *vec, T value);                            \
+    Name *prefix##_copy(const Name *vec);                                        \
+    void prefix##_extend(Name *dest, const Name *src);                           \
+    bool prefix##_equals(const Name *a, const Name *b)
+
+/* VECTOR_DECLARE plus the ordered operations */
+#define VECTOR_DECLARE_ORDERED(Name, prefix, T)                                  \
+    VECTOR_DECLARE(Name, prefix, T);                                             \
+    void prefix##_sort(Name *vec);                                               \
+    bool prefix##_is_sorted(Name *vec);                                          \
+    size_t prefix##_lower_bound(const Name *vec, T value);                       \
+    size_t prefix##_upper_bound(const Name *vec, T value);                       \
+    size_t prefix##_dedup(Name *vec);                                            \
+    Name *prefix##_set_union(const Name *a, const Name *b);                      \
+    Name *prefix##_set_intersection(const Name *a, const Name *b);               \
+    Name *prefix##_set_difference(const Name *a, const Name *b)
+
+/* Struct and out-of-line definitions, for exactly one .c file */
+#define VECTOR_DEFINE(Name, prefix, T)                                           \
+    VECTOR_IMPL_(Name, prefix, T, , static, VECTOR_UNORDERED_)
+
+/* Struct and static inline definitions, for use from a header */
+#define VECTOR_DEFINE_INLINE(Name, prefix, T)                                    \
+    typedef struct Name Name;                                                    \
+    VECTOR_IMPL_(Name, prefix, T, static inline, static inline,                  \
+                 VECTOR_UNORDERED_)
+
+
+/* VECTOR_DEFINE / VECTOR_DEFINE_INLINE plus the ordered operations */
+#define VECTOR_DEFINE_ORDERED(Name, prefix, T)                                   \
+    VECTOR_IMPL_(Name, prefix, T, , static, VECTOR_LESS_);                       \
+    VECTOR_ORDERED_IMPL_(Name, prefix, T, , static, VECTOR_LESS_)
+
+#define VECTOR_DEFINE_INLINE_ORDERED(Name, prefix, T)                            \
+    typedef struct Name Name;                                                    \
+    VECTOR_IMPL_(Name, prefix, T, static inline, static inline, VECTOR_LESS_);   \
+    VECTOR_ORDERED_IMPL_(Name, prefix, T, static inline, static inline,          \
+                         VECTOR_LESS_)
+
+/* Counting code of the stats build (see vector_stats.h); absent otherwise */
+#ifdef VECTOR_STATS
+#define VECTOR_STATS_ONLY_(...) __VA_ARGS__
+#else
+#define VECTOR_STATS_ONLY_(...)
+#endif
+
+/* Orders for VECTOR_IMPL_: < for ordered vectors, none otherwise */
+#define VECTOR_LESS_(a, b) ((a) < (b))
+#define VECTOR_UNORDERED_(a, b) ((void)(a), (void)(b), 0)
+
+
+/*
+ * The implementation. API is the storage class of the public functions,
+ * HELPER that of the internal ones (static either way). LESS(a, b) orders
+ * elements; VECTOR_UNORDERED_ for types without an order, whose sorted
+ * flag is then never set.
+ */
+#define VECTOR_IMPL_(Name, prefix, T, API, HELPER, LESS)                         \
+    struct Name {                                                                \
+        T *data;                                                                 \
+        size_t size;                                                             \
+        size_t capacity;                                                         \
+        const VectorAllocator *allocator;  /* NULL: malloc/realloc/free */       \
+        size_t growth_step;  /* increment for VECTOR_GROWTH_FIXED */             \
+        unsigned char growth;  /* VectorGrowth */                                \
+        bool sorted;  /* known ascending: set by sort, cleared by writes */      \
+        T small[VECTOR_INLINE_CAPACITY(T)];  /* data while it fits */            \
+        VECTOR_STATS_ONLY_(VectorStats stats;)                                   \
+    };                                                                           \
+                                                                                 \
+    /* Reallocate to exactly new_capacity elements. Capacities that fit */       \
+    /* the inline buffer use it, and free the heap block if there is one */      \
+    HELPER bool prefix##_resize(Name *vec, size_t new_capacity) {                \
+        assert(vec != NULL);                                                     \
+        assert(new_capacity >= vec->size);                                       \
+        size_t old_bytes = vec->capacity * sizeof(T);                            \
+                                                                                 \
+        if (new_capacity <= VECTOR_INLINE_CAPACITY(T)) {                         \
+            if (vec->data != vec->small) {                                       \
+                memcpy(vec->small, vec->data, vec->size * sizeof(T));            \
+                vector_mem_free(vec->allocator, vec->data, old_bytes);           \
+                vec->data = vec->small;                                          \
+                VECTOR_STATS_ONLY_(vector_stats_record_resize_(&vec->stats,      \
+                    old_bytes, 0, 0, vec->size * sizeof(T));)                    \
+            }                                                                    \
+            vec->capacity = new_capacity;                                        \
+            return true;                                                         \
+        }                                                                        \
+        if (new_capacity > SIZE_MAX / sizeof(T)) return false;                   \
+                                                                                 \
+        T *new_data;                                                             \
+        if (vec->data == vec->small) {                                           \
+            new_data = vector_mem_alloc(vec->allocator,                          \
+                                        new_capacity * sizeof(T));               \
+            if (!new_data) return false;                                         \
+            memcpy(new_data, vec->small, vec->size * sizeof(T));                 \
+            VECTOR_STATS_ONLY_(vector_stats_record_resize_(&vec->stats, 0,       \
+                new_capacity * sizeof(T), new_capacity * sizeof(T),              \
+                vec->size * sizeof(T));)                                         \
+        } else {                                                                 \
+            VECTOR_STATS_ONLY_(uintptr_t old_addr = (uintptr_t)vec->data;)       \
+            new_data = vector_mem_realloc(vec->allocator, vec->data, old_bytes,  \
+                                          new_capacity * sizeof(T));             \
+            if (!new_data) return false;                                         \
+            VECTOR_STATS_ONLY_(bool copied = (uintptr_t)new_data != old_addr &&  \
+                vector_mem_realloc_copies(vec->allocator, old_bytes,             \
+                                          new_capacity * sizeof(T));)            \
+            VECTOR_STATS_ONLY_(vector_stats_record_resize_(&vec->stats,          \
+                old_bytes, new_capacity * sizeof(T), new_capacity * sizeof(T),   \
+                copied ? vec->size * sizeof(T) : 0);)                            \
+        }                                                                        \
+                                                                                 \
+        vec->data = new_data;                                                    \
+        vec->capacity = new_capacity;                                            \
+        return true;                                                             \
+    }                                                                            \
+                                                                                 \
+    /* Grow by the vector's policy until at least min_capacity elements fit */   \
+    HELPER void prefix##_grow(Name *vec, size_t min_capacity) {                  \
+        size_t new_cap = vec->capacity > 0 ? vec->capacity                       \
+                                           : VECTOR_DEFAULT_SIZE;                \
+        if (new_cap < min_capacity) {                                            \
+            new_cap = vector_next_capacity((VectorGrowth)vec->growth,            \
+                                           vec->growth_step, new_cap,            \
+                                           min_capacity);                        \
+            assert(new_cap != 0);                                                \
+        }                                                                        \
+        /* Fill the inline buffer before going to the heap */                    \
+        if (min_capacity <= VECTOR_INLINE_CAPACITY(T) &&                         \
+            new_cap > VECTOR_INLINE_CAPACITY(T)) {                               \
+            new_cap = VECTOR_INLINE_CAPACITY(T);                                 \
+        }                                                                        \
+        bool success = prefix##_resize(vec, new_cap);                            \
+        assert(success);                                                         \
+        (void)success;                                                           \
+    }                                                                            \
+                                                                                 \
+    /* Set up a vector in caller-provided memory (stack, another struct) */      \
+    API Name *prefix##_init(Name *vec, const VectorAllocator *allocator) {       \
+        assert(vec != NULL);                                                     \
+        vec->data = vec->small;                                                  \
+        vec->size = 0;                                                           \
+        vec->capacity = VECTOR_INLINE_CAPACITY(T);                               \
+        vec->allocator = allocator;                                              \
+        vec->growth_step = 0;                                                    \
+        vec->growth = VECTOR_GROWTH_DOUBLE;                                      \
+        vec->sorted = false;                                                     \
+        VECTOR_STATS_ONLY_(memset(&vec->stats, 0, sizeof(vec->stats));)          \
+        return vec;                                                              \
+    }                                                                            \
+                                                                                 \
+    /* Free the heap data of an initialized vector; it stays usable (empty) */   \
+    API void prefix##_release(Name *vec) {                                       \
+        assert(vec != NULL);                                                     \
+        if (vec->data != vec->small) {                                           \
+            VECTOR_STATS_ONLY_(vector_stats_record_release_(&vec->stats,         \
+                vec->capacity * sizeof(T), vec->size * sizeof(T));)              \
+            vector_mem_free(vec->allocator, vec->data,                           \
+                            vec->capacity * sizeof(T));                          \
+        }                                                                        \
+        vec->data = vec->small;                                                  \
+        vec->size = 0;                                                           \
+        vec->capacity = VECTOR_INLINE_CAPACITY(T);                               \
+        vec->sorted = false;                                                     \
+    }                                                                            \
+                                                                                 \
+    API Name *prefix##_create_with(size_t initial_capacity,                      \
+                                   const VectorAllocator *allocator) {           \
+        Name *vec = vector_mem_alloc(allocator, sizeof(Name));                   \
+        if (!vec) return NULL;                                                   \
+                                                                                 \
+        size_t cap = initial_capacity > 0 ? initial_capacity                     \
+                                          : VECTOR_DEFAULT_SIZE;                 \
+        prefix##_init(vec, allocator);                                           \
+        if (!prefix##_resize(vec, cap)) {                                        \
+            vector_mem_free(allocator, vec, sizeof(Name));                       \
+            return NULL;                                                         \
+        }                                                                        \
+        return vec;                                                              \
+    }                                                                            \
+                                                                                 \
+    API Name *prefix##_create(size_t initial_capacity) {                         \
+        return prefix##_create_with(initial_capacity, NULL);                     \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_destroy(Name *vec) {                                       \
+        assert(vec != NULL);                                                     \
+        prefix##_release(vec);                                                   \
+        vector_mem_free(vec->allocator, vec, sizeof(Name));                      \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_clear(Name *vec) {                                         \
+        assert(vec != NULL);                                                     \
+        vec->size = 0;                                                           \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_push(Name *vec, T value) {                                 \
+        assert(vec != NULL);                                                     \
+        if (vec->size == vec->capacity) {                                        \
+            prefix##_grow(vec, vec->size + 1);                                   \
+        }                                                                        \
+        vec->data[vec->size++] = value;                                          \
+        vec->sorted = false;                                                     \
+    }                                                                            \
+                                                                                 \
+    API T prefix##_pop(Name *vec) {                                              \
+        assert(vec != NULL);                                                     \
+        assert(vec->size != 0);                                                  \
+        return vec->data[--vec->size];                                           \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_insert(Name *vec, size_t index, T value) {                 \
+        assert(vec != NULL);                                                     \
+        assert(index <= vec->size);                                              \
+        if (vec->size == vec->capacity) {                                        \
+            prefix##_grow(vec, vec->size + 1);                                   \
+        }                                                                        \
+        memmove(vec->data + index + 1, vec->data + index,                        \
+                (vec->size - index) * sizeof(T));                                \
+        VECTOR_STATS_ONLY_(vector_stats_record_shift_(&vec->stats,               \
+            (vec->size - index) * sizeof(T));)                                   \
+        vec->data[index] = value;                                                \
+        vec->size++;                                                             \
+        vec->sorted = false;                                                     \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_remove(Name *vec, size_t index) {                          \
+        assert(vec != NULL);                                                     \
+        assert(index < vec->size);                                               \
+        memmove(vec->data + index, vec->data + index + 1,                        \
+                (vec->size - index - 1) * sizeof(T));                            \
+        VECTOR_STATS_ONLY_(vector_stats_record_shift_(&vec->stats,               \
+            (vec->size - index - 1) * sizeof(T));)                               \
+        vec->size--;                                                             \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_push_n(Name *vec, T value, size_t count) {                 \
+        assert(vec != NULL);                                                     \
+        if (count > vec->capacity - vec->size) {                                 \
+            prefix##_grow(vec, vec->size + count);                               \
+        }                                                                        \
+        T *out = vec->data + vec->size;                                          \
+        for (size_t i = 0; i < count; i++) {                                     \
+            out[i] = value;                                                      \
+        }                                                                        \
+        vec->size += count;                                                      \
+        vec->sorted = false;                                                     \
+    }                                                                            \
+                                                                                 \
+    /* values may point into vec itself: it is re-based if the block moves */    \
+    API void prefix##_insert_range(Name *vec, size_t index, const T *values,     \
+                                   size_t count) {                               \
+        assert(vec != NULL);                                                     \
+        assert(index <= vec->size);                                              \
+        assert(values != NULL || count == 0);                                    \
+        if (count == 0) return;                                                  \
+                                                                                 \
+        uintptr_t first = (uintptr_t)vec->data;                                  \
+        uintptr_t at = (uintptr_t)values;                                        \
+        bool inside = vec->data != NULL && at >= first &&                        \
+                      at < first + vec->size * sizeof(T);                        \
+        size_t offset = inside ? (size_t)(at - first) / sizeof(T) : 0;           \
+                                                                                 \
+        if (count > vec->capacity - vec->size) {                                 \
+            prefix##_grow(vec, vec->size + count);                               \
+        }                                                                        \
+        T *gap = vec->data + index;                                              \
+        memmove(gap + count, gap, (vec->size - index) * sizeof(T));              \
+        VECTOR_STATS_ONLY_(vector_stats_record_shift_(&vec->stats,               \
+            (vec->size - index) * sizeof(T));)                                   \
+        if (!inside) {                                                           \
+            memcpy(gap, values, count * sizeof(T));                              \
+        } else {                                                                 \
+            /* The source was split (or moved) by the shift above */             \
+            for (size_t i = 0; i < count; i++) {                                 \
+                size_t from = offset + i;                                        \
+                gap[i] = vec->data[from < index ? from : from + count];          \
+            }                                                                    \
+        }                                                                        \
+        vec->size += count;                                                      \
+        vec->sorted = false;                                                     \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_append(Name *vec, const T *values, size_t count) {         \
+        prefix##_insert_range(vec, vec->size, values, count);                    \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_remove_range(Name *vec, size_t index, size_t count) {      \
+        assert(vec != NULL);                                                     \
+        assert(index <= vec->size && count <= vec->size - index);                \
+        if (count == 0) return;                                                  \
+        memmove(vec->data + index, vec->data + index + count,                    \
+                (vec->size - index - count) * sizeof(T));                        \
+        VECTOR_STATS_ONLY_(vector_stats_record_shift_(&vec->stats,               \
+            (vec->size - index - count) * sizeof(T));)                           \
+        vec->size -= count;                                                      \
+    }                                                                            \
+                                                                                 \
+    /* Stable single-pass compaction; returns the number of removed elements */  \
+    API size_t prefix##_erase_if(Name *vec, bool (*pred)(T value, void *ctx),    \
+                                 void *ctx) {                                    \
+        assert(vec != NULL);                                                     \
+        assert(pred != NULL);                                                    \
+        size_t kept = 0;                                                         \
+        for (size_t i = 0; i < vec->size; i++) {                                 \
+            if (!pred(vec->data[i], ctx)) {                                      \
+                vec->data[kept++] = vec->data[i];                                \
+            }                                                                    \
+        }                                                                        \
+        size_t removed = vec->size - kept;                                       \
+        vec->size = kept;                                                        \
+        return removed;                                                          \
+    }                                                                            \
+                                                                                 \
+    API T prefix##_get(const Name *vec, size_t index) {                          \
+        assert(vec != NULL);                                                     \
+        assert(index < vec->size);                                               \
+        return vec->data[index];                                                 \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_set(Name *vec, size_t index, T value) {                    \
+        assert(vec != NULL);                                                     \
+        assert(index < vec->size);                                               \
+        vec->data[index] = value;                                                \
+        vec->sorted = false;                                                     \
+    }                                                                            \
+                                                                                 \
+    API size_t prefix##_size(const Name *vec) {                                  \
+        assert(vec != NULL);                                                     \
+        return vec->size;                                                        \
+    }                                                                            \
+                                                                                 \
+    API size_t prefix##_capacity(const Name *vec) {                              \
+        assert(vec != NULL);                                                     \
+        return vec->capacity;                                                    \
+    }                                                                            \
+                                                                                 \
+    API bool prefix##_is_empty(const Name *vec) {                                \
+        assert(vec != NULL);                                                     \
+        return vec->size == 0;                                                   \
+    }                                                                            \
+                                                                                 \
+    API bool prefix##_is_full(const Name *vec) {                                 \
+        assert(vec != NULL);                                                     \
+        return vec->size == vec->capacity;                                       \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_reserve(Name *vec, size_t new_capacity) {                  \
+        assert(vec != NULL);                                                     \
+        if (new_capacity > vec->capacity) {                                      \
+            bool success = prefix##_resize(vec, new_capacity);                   \
+            assert(success);                                                     \
+            (void)success;                                                       \
+        }                                                                        \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_shrink_to_fit(Name *vec) {                                 \
+        assert(vec != NULL);                                                     \
+        if (vec->size < vec->capacity) {                                         \
+            bool success = prefix##_resize(vec, vec->size);                      \
+            assert(success);                                                     \
+            (void)success;                                                       \
+        }                                                                        \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_set_growth(Name *vec, VectorGrowth growth,                 \
+                                 size_t increment) {                             \
+        assert(vec != NULL);                                                     \
+        assert(growth != VECTOR_GROWTH_FIXED || increment > 0);                  \
+        vec->growth = (unsigned char)growth;                                     \
+        vec->growth_step = increment;                                            \
+    }                                                                            \
+                                                                                 \
+    /* Counters of this vector (all zero without VECTOR_STATS) */                \
+    API void prefix##_stats(const Name *vec, VectorStats *out) {                 \
+        assert(vec != NULL);                                                     \
+        assert(out != NULL);                                                     \
+        (void)vec;                                                               \
+        memset(out, 0, sizeof(*out));                                            \
+        VECTOR_STATS_ONLY_(*out = vec->stats;                                    \
+            out->wasted_bytes = vec->data == vec->small ? 0                      \
+                : (vec->capacity - vec->size) * sizeof(T);)                      \
+    }                                                                            \
+                                                                                 \
+    /* First index whose element is not less than value (branch-free) */         \
+    HELPER size_t prefix##_lower_bound_(const T *data, size_t size, T value) {   \
+        const T *base = data;                                                    \
+        if (size == 0) return 0;                                                 \
+        while (size > 1) {                                                       \
+            size_t half = size / 2;                                              \
+            base = LESS(base[half], value) ? base + half : base;                 \
+            size -= half;                                                        \
+        }                                                                        \
+        return (size_t)(base - data) + (LESS(*base, value) ? 1 : 0);             \
+    }                                                                            \
+                                                                                 \
+    API int prefix##_find(const Name *vec, T value) {                            \
+        assert(vec != NULL);                                                     \
+        if (vec->sorted) {                                                       \
+            /* O(log n); equality is !(a < b) && !(b < a) here */                \
+            size_t i = prefix##_lower_bound_(vec->data, vec->size, value);       \
+            return i < vec->size && !LESS(value, vec->data[i]) ? (int)i : -1;    \
+        }                                                                        \
+        if (sizeof(T) == sizeof(uint32_t)) {                                     \
+            /* 4-byte elements: SSE2/AVX2 kernel from vector_simd.c */           \
+            union { T value; uint32_t bits; } key;                               \
+            key.value = value;                                                   \
+            size_t i = vector_simd_find32(vec->data, vec->size, key.bits);       \
+            return i < vec->size ? (int)i : -1;                                  \
+        }                                                                        \
+        for (size_t i = 0; i < vec->size; i++) {                                 \
+            if (memcmp(&vec->data[i], &value, sizeof(T)) == 0) {                 \
+                return (int)i;                                                   \
+            }                                                                    \
+        }                                                                        \
+        return -1;                                                               \
+    }                                                                            \
+                                                                                 \
+    API bool prefix##_contains(const Name *vec, T value) {                       \
+        assert(vec != NULL);                                                     \
+        return prefix##_find(vec, value) != -1;                                  \
+    }                                                                            \
+                                                                                 \
+    API Name *prefix##_copy(const Name *vec) {                                   \
+        assert(vec != NULL);                                                     \
+        Name *copy = prefix##_create_with(vec->capacity, vec->allocator);        \
+        if (!copy) return NULL;                                                  \
+        if (vec->size > 0) {                                                     \
+            memcpy(copy->data, vec->data, vec->size * sizeof(T));                \
+        }                                                                        \
+        copy->size = vec->size;                                                  \
+        copy->growth_step = vec->growth_step;                                    \
+        copy->growth = vec->growth;                                              \
+        copy->sorted = vec->sorted;                                              \
+        return copy;                                                             \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_extend(Name *dest, const Name *src) {                      \
+        assert(dest != NULL);                                                    \
+        assert(src != NULL);                                                     \
+        /* Extending a vector with itself is allowed (append re-bases) */        \
+        prefix##_append(dest, src->data, src->size);                             \
+    }                                                                            \
+                                                                                 \
+    API bool prefix##_equals(const Name *a, const Name *b) {                     \
+        assert(a != NULL);                                                       \
+        assert(b != NULL);                                                       \
+        if (a->size != b->size) return false;                                    \
+        return a->size == 0 ||                                                   \
+               memcmp(a->data, b->data, a->size * sizeof(T)) == 0;               \
+    }                                                                            \
+    typedef int prefix##_defined_ /* lets the macro end with a semicolon */
+
+/*
+ * The ordered operations, generated after VECTOR_IMPL_ with the same LESS.
+ * The set operations take sorted inputs (checked by assert) and return a
+ * new sorted vector from a's allocator, NULL if out of memory; duplicates
+ * follow multiset rules, as in C++ std::set_union and friends.
+ */
+#define VECTOR_ORDERED_IMPL_(Name, prefix, T, API, HELPER, LESS)                 \
+    HELPER bool prefix##_sorted_range_(const T *data, size_t size) {             \
+        for (size_t i = 1; i < size; i++) {                                      \
+            if (LESS(data[i], data[i - 1])) return false;                        \
+        }                                                                        \
+        return true;                                                             \
+    }                                                                            \
+                                                                                 \
+    HELPER void prefix##_insertion_sort_(T *data, size_t size) {                 \
+        for (size_t i = 1; i < size; i++) {                                      \
+            T value = data[i];                                                   \
+            size_t j = i;                                                        \
+            while (j > 0 && LESS(value, data[j - 1])) {                          \
+                data[j] = data[j - 1];                                           \
+                j--;                                                             \
+            }                                                                    \
+            data[j] = value;                                                     \
+        }                                                                        \
+    }                                                                            \
+                                                                                 \
+    HELPER void prefix##_sift_down_(T *data, size_t root, size_t size) {         \
+        for (;;) {                                                               \
+            size_t child = 2 * root + 1;                                         \
+            if (child >= size) return;                                           \
+            if (child + 1 < size && LESS(data[child], data[child + 1])) {        \
+                child++;                                                         \
+            }                                                                    \
+            if (!LESS(data[root], data[child])) return;                          \
+            T tmp = data[root];                                                  \
+            data[root] = data[child];                                            \
+            data[child] = tmp;                                                   \
+            root = child;                                                        \
+        }                                                                        \
+    }                                                                            \
+                                                                                 \
+    HELPER void prefix##_heap_sort_(T *data, size_t size) {                      \
+        for (size_t i = size / 2; i-- > 0;) {                                    \
+            prefix##_sift_down_(data, i, size);                                  \
+        }                                                                        \
+        for (size_t end = size; end-- > 1;) {                                    \
+            T tmp = data[0];                                                     \
+            data[0] = data[end];                                                 \
+            data[end] = tmp;                                                     \
+            prefix##_sift_down_(data, 0, end);                                   \
+        }                                                                        \
+    }                                                                            \
+                                                                                 \
+    /* Quicksort with a median-of-three pivot and Hoare partitioning; */         \
+    /* recurses into the smaller side, so the stack stays O(log n) */            \
+    HELPER void prefix##_introsort_(T *data, size_t size, unsigned depth) {      \
+        while (size > VECTOR_INSERTION_SORT_MAX) {                               \
+            if (depth-- == 0) {                                                  \
+                prefix##_heap_sort_(data, size);                                 \
+                return;                                                          \
+            }                                                                    \
+            size_t mid = size / 2, last = size - 1;                              \
+            T tmp;                                                               \
+            if (LESS(data[mid], data[0])) {                                      \
+                tmp = data[mid]; data[mid] = data[0]; data[0] = tmp;             \
+            }                                                                    \
+            if (LESS(data[last], data[0])) {                                     \
+                tmp = data[last]; data[last] = data[0]; data[0] = tmp;           \
+            }                                                                    \
+            if (LESS(data[last], data[mid])) {                                   \
+                tmp = data[last]; data[last] = data[mid]; data[mid] = tmp;       \
+            }                                                                    \
+            T pivot = data[mid];                                                 \
+            size_t i = 0, j = last;                                              \
+            for (;;) {                                                           \
+                while (LESS(data[i], pivot)) i++;                                \
+                while (LESS(pivot, data[j])) j--;                                \
+                if (i >= j) break;                                               \
+                tmp = data[i]; data[i] = data[j]; data[j] = tmp;                 \
+                i++;                                                             \
+                j--;                                                             \
+            }                                                                    \
+            size_t left = j + 1;  /* [0, left) <= pivot <= [left, size) */       \
+            if (left < size - left) {                                            \
+                prefix##_introsort_(data, left, depth);                          \
+                data += left;                                                    \
+                size -= left;                                                    \
+            } else {                                                             \
+                prefix##_introsort_(data + left, size - left, depth);            \
+                size = left;                                                     \
+            }                                                                    \
+        }                                                                        \
+        prefix##_insertion_sort_(data, size);                                    \
+    }                                                                            \
+                                                                                 \
+    API void prefix##_sort(Name *vec) {                                          \
+        assert(vec != NULL);                                                     \
+        size_t n = vec->size;                                                    \
+        if (vec->sorted || prefix##_sorted_range_(vec->data, n)) {               \
+            vec->sorted = true;                                                  \
+            return;                                                              \
+        }                                                                        \
+        bool done = false;                                                       \
+        /* 4-byte integers: O(n) radix sort (the casts are only taken then) */   \
+        if (n >= VECTOR_RADIX_SORT_MIN && sizeof(T) == sizeof(uint32_t) &&       \
+            (T)1 / 2 == 0) {                                                     \
+            done = (T)-1 < (T)1                                                  \
+                 ? vector_radix_sort_i32((int32_t *)(void *)vec->data, n)        \
+                 : vector_radix_sort_u32((uint32_t *)(void *)vec->data, n);      \
+        }                                                                        \
+        if (!done) {                                                             \
+            unsigned depth = 0;                                                  \
+            for (size_t m = n; m > 1; m >>= 1) depth += 2;                       \
+            prefix##_introsort_(vec->data, n, depth);                            \
+        }                                                                        \
+        vec->sorted = true;                                                      \
+    }                                                                            \
+                                                                                 \
+    /* O(1) when already known; otherwise one pass, remembered if sorted */      \
+    API bool prefix##_is_sorted(Name *vec) {                                     \
+        assert(vec != NULL);                                                     \
+        if (!vec->sorted) {                                                      \
+            vec->sorted = prefix##_sorted_range_(vec->data, vec->size);          \
+        }                                                                        \
+        return vec->sorted;                                                      \
+    }                                                                            \
+                                                                                 \
+    API size_t prefix##_lower_bound(const Name *vec, T value) {                  \
+        assert(vec != NULL);                                                     \
+        return prefix##_lower_bound_(vec->data, vec->size, value);               \
+    }                                                                            \
+                                                                                 \
+    /* First index whose element is greater than value (branch-free) */          \
+    API size_t prefix##_upper_bound(const Name *vec, T value) {                  \
+        assert(vec != NULL);                                                     \
+        const T *base = vec->data;                                               \
+        size_t size = vec->size;                                                 \
+        if (size == 0) return 0;                                                 \
+        while (size > 1) {                                                       \
+            size_t half = size / 2;                                              \
+            base = !LESS(value, base[half]) ? base + half : base;                \
+            size -= half;                                                        \
+        }                                                                        \
+        return (size_t)(base - vec->data) + (!LESS(value, *base) ? 1 : 0);       \
+    }                                                                            \
+                                                                                 \
+    /* Drops adjacent equal elements (all duplicates once sorted) */             \
+    API size_t prefix##_dedup(Name *vec) {                                       \
+        assert(vec != NULL);                                                     \
+        if (vec->size < 2) return 0;                                             \
+        size_t kept = 1;                                                         \
+        for (size_t i = 1; i < vec->size; i++) {                                 \
+            T prev = vec->data[kept - 1];                                        \
+            if (LESS(prev, vec->data[i]) || LESS(vec->data[i], prev)) {          \
+                vec->data[kept++] = vec->data[i];                                \
+            }                                                                    \
+        }                                                                        \
+        size_t removed = vec->size - kept;                                       \
+        vec->size = kept;                                                        \
+        return removed;                                                          \
+    }                                                                            \
+                                                                                 \
+    /* Elements of a or b (an element in both is taken once per pair) */         \
+    API Name *prefix##_set_union(const Name *a, const Name *b) {                 \
+        assert(a != NULL && b != NULL);                                          \
+        assert(prefix##_sorted_range_(a->data, a->size));                        \
+        assert(prefix##_sorted_range_(b->data, b->size));                        \
+        if (a->size > SIZE_MAX - b->size) return NULL;                           \
+        Name *out = prefix##_create_with(a->size + b->size, a->allocator);       \
+        if (!out) return NULL;                                                   \
+        size_t i = 0, j = 0, n = 0;                                              \
+        while (i < a->size && j < b->size) {                                     \
+            if (LESS(b->data[j], a->data[i])) {                                  \
+                out->data[n++] = b->data[j++];                                   \
+            } else {                                                             \
+                if (!LESS(a->data[i], b->data[j])) j++;                          \
+                out->data[n++] = a->data[i++];                                   \
+            }                                                                    \
+        }                                                                        \
+        while (i < a->size) out->data[n++] = a->data[i++];                       \
+        while (j < b->size) out->data[n++] = b->data[j++];                       \
+        out->size = n;                                                           \
+        out->sorted = true;                                                      \
+        return out;                                                              \
+    }                                                                            \
+                                                                                 \
+    /* Elements of a that are also in b */                                       \
+    API Name *prefix##_set_intersection(const Name *a, const Name *b) {          \
+        assert(a != NULL && b != NULL);                                          \
+        assert(prefix##_sorted_range_(a->data, a->size));                        \
+        assert(prefix##_sorted_range_(b->data, b->size));                        \
+        size_t cap = a->size < b->size ? a->size : b->size;                      \
+        Name *out = prefix##_create_with(cap, a->allocator);                     \
+        if (!out) return NULL;                                                   \
+        size_t i = 0, j = 0, n = 0;                                              \
+        while (i < a->size && j < b->size) {                                     \
+            if (LESS(a->data[i], b->data[j])) {                                  \
+                i++;                                                             \
+            } else if (LESS(b->data[j], a->data[i])) {                           \
+                j++;                                                             \
+            } else {                                                             \
+                out->data[n++] = a->data[i++];                                   \
+                j++;                                                             \
+            }                                                                    \
+        }                                                                        \
+        out->size = n;                                                           \
+        out->sorted = true;                                                      \
+        return out;                                                              \
+    }                                                                            \
+                                                                                 \
+    /* Elements of a that are not in b */                                        \
+    API Name *prefix##_set_difference(const Name *a, const Name *b) {            \
+        assert(a != NULL && b != NULL);                                          \
+        assert(prefix##_sorted_range_(a->data, a->size));                        \
+        assert(prefix##_sorted_range_(b->data, b->size));                        \
+        Name *out = prefix##_create_with(a->size, a->allocator);                 \
+        if (!out) return NULL;                                                   \
+        size_t i = 0, j = 0, n = 0;                                              \
+        while (i < a->size && j < b->size) {                                     \
+            if (LESS(a->data[i], b->data[j])) {                                  \
+                out->data[n++] = a->data[i++];                                   \
+            } else {                                                             \
+                if (!LESS(b->data[j], a->data[i])) i++;                          \
+                j++;                                                             \
+            }                                                                    \
+        }                                                                        \
+        while (i < a->size) out->data[n++] = a->data[i++];                       \
+        out->size = n;                                                           \
+        out->sorted = true;                                                      \
+        return out;                                                              \
+    }                                                                            \
+    typedef int prefix##_ordered_defined_ /* lets the macro end with a semicolon */
+
+#endif /* VECTOR_GENERIC_H */
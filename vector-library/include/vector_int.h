@@ -3,6 +3,11 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include "vector_alloc.h"
+#include "vector_compressed.h"
+#include "vector_io.h"
+#include "vector_stats.h"
 
 /*
  * IntVector - A dynamic array for integers
@@ -12,13 +17,34 @@
  * - Automatic memory management with growth/shrink
  * - Bounds checking on access
  * - Clean, consistent API
+ * - Up to INT_VECTOR_INLINE_CAPACITY ints are stored inside the IntVector
+ *   itself: no data allocation for short vectors, and no malloc at all
+ *   for an IntVector placed in an IntVectorStorage on the stack
  */
 
 typedef struct IntVector IntVector;
 
+#define INT_VECTOR_INLINE_CAPACITY 16   // ints that fit before the data moves to the heap
+
+#ifdef VECTOR_STATS
+#define INT_VECTOR_STATS_BYTES sizeof(VectorStats)   // Counters at the end of the struct
+#else
+#define INT_VECTOR_STATS_BYTES 0
+#endif
+
+// Caller-owned memory for an IntVector (a local, or a member of another struct)
+typedef union IntVectorStorage {
+    unsigned char bytes[6 * sizeof(void *) + INT_VECTOR_INLINE_CAPACITY * sizeof(int) + INT_VECTOR_STATS_BYTES];  // Header words, the inline ints, stats
+    void *align_ptr;
+    int64_t align_int;
+} IntVectorStorage;
+
 //Creation and Destruction
 IntVector *int_vector_create(size_t initial_capacity);          // Create a new vector with given initial capacity (0 for default)
+IntVector *int_vector_create_with(size_t initial_capacity, const VectorAllocator *allocator); // Same, but all memory comes from allocator (must outlive the vector)
 void int_vector_destroy(IntVector *vec);                        // Destroy a vector, freeing all memory
+IntVector *int_vector_init_storage(IntVectorStorage *storage, const VectorAllocator *allocator); // Vector living in storage, no allocation until it outgrows the inline buffer (NULL allocator: malloc)
+void int_vector_release(IntVector *vec);                        // Free the heap data of a vector from init_storage (it stays usable, empty); never destroy() one
 void int_vector_clear(IntVector *vec);                          // Clear all elements from vector (size=0, keeps capacity)
 
 
@@ -28,6 +54,13 @@ int int_vector_pop(IntVector *vec);                             // Remove and re
 void int_vector_insert(IntVector *vec, size_t index, int value);// Insert value at specified index (shifts elements right)
 void int_vector_remove(IntVector *vec, size_t index);           // Remove element at specified index (shifts elements left)
 
+// Bulk Operations (one capacity check and one memmove/memcpy per call)
+void int_vector_push_n(IntVector *vec, int value, size_t count);                        // Append count copies of value
+void int_vector_append(IntVector *vec, const int *values, size_t count);                // Append count ints from a raw array
+void int_vector_insert_range(IntVector *vec, size_t index, const int *values, size_t count); // Insert count ints at index (values may point into vec)
+void int_vector_remove_range(IntVector *vec, size_t index, size_t count);               // Remove count elements starting at index
+size_t int_vector_erase_if(IntVector *vec, bool (*pred)(int value, void *ctx), void *ctx); // Remove elements where pred is true (stable); returns count removed
+
 // Accessors
 int int_vector_get(const IntVector *vec, size_t index);         // Get element at index (bounds checked)
 void int_vector_set(IntVector *vec, size_t index, int value);   // Set element at index to value (bounds checked)
@@ -40,10 +73,51 @@ bool int_vector_is_full(const IntVector *vec);                  // Check if vect
 // Memory Management
 void int_vector_reserve(IntVector *vec, size_t new_capacity);   // Ensure vector has at least given capacity
 void int_vector_shrink_to_fit(IntVector *vec);                  // Reduce capacity to match current size
+void int_vector_set_growth(IntVector *vec, VectorGrowth growth, size_t increment); // Capacity policy when full: VECTOR_GROWTH_DOUBLE (default), _HALF (1.5x) or _FIXED (+increment)
 
 // Search Operations
-int int_vector_find(const IntVector *vec, int value);           // Find first occurrence of value, return index or -1 if not found
+int int_vector_find(const IntVector *vec, int value);           // Find first occurrence of value, return index or -1 if not found (O(log n) once known sorted)
 bool int_vector_contains(const IntVector *vec, int value);      // Check if vector contains value
+size_t int_vector_count_equal(const IntVector *vec, int value); // Count occurrences of value
+
+// Ordering (the vector remembers it is sorted until the next push/insert/set)
+void int_vector_sort(IntVector *vec);                           // Sort ascending (LSD radix sort, O(n); no-op if already sorted)
+bool int_vector_is_sorted(IntVector *vec);                      // Check ascending order (O(n) once, then O(1)); enables binary search in find
+size_t int_vector_lower_bound(const IntVector *vec, int value); // First index with element >= value (vector must be sorted, O(log n))
+size_t int_vector_upper_bound(const IntVector *vec, int value); // First index with element > value (vector must be sorted, O(log n))
+size_t int_vector_dedup(IntVector *vec);                        // Remove adjacent duplicates (all duplicates if sorted); returns count removed
+
+// Sorted Set Operations (inputs must be sorted; result is a new sorted vector, NULL on failure)
+IntVector *int_vector_set_union(const IntVector *a, const IntVector *b);        // Elements in a or b
+IntVector *int_vector_set_intersection(const IntVector *a, const IntVector *b); // Elements in both a and b
+IntVector *int_vector_set_difference(const IntVector *a, const IntVector *b);   // Elements in a but not in b
+
+// Reductions (SSE2/AVX2 kernels chosen at runtime, see vector_simd.h)
+int64_t int_vector_sum(const IntVector *vec);                   // Sum of all elements as int64 (no overflow; 0 if empty)
+int int_vector_min(const IntVector *vec);                       // Smallest element (vector must not be empty)
+int int_vector_max(const IntVector *vec);                       // Largest element (vector must not be empty)
+size_t int_vector_min_index(const IntVector *vec);              // Index of the first smallest element (not empty)
+size_t int_vector_max_index(const IntVector *vec);              // Index of the first largest element (not empty)
+
+// Parallel Operations (thread pool of vector_parallel.h; serial below two grains, link with -pthread)
+void int_vector_parallel_sort(IntVector *vec);                  // Sort ascending: chunks radix-sorted in parallel, then parallel merges
+int64_t int_vector_parallel_sum(const IntVector *vec);          // Same result as int_vector_sum
+int64_t int_vector_parallel_reduce(const IntVector *vec, int64_t identity, int64_t (*op)(int64_t acc, int64_t value)); // Fold with an associative op (identity for empty vectors)
+void int_vector_parallel_transform(IntVector *vec, int (*fn)(int value, void *ctx), void *ctx); // Replace each element with fn(element), in place (fn must be thread-safe)
+void int_vector_parallel_prefix_sum(IntVector *vec);            // Inclusive running sums, in place (wraps around instead of overflowing)
+IntVector *int_vector_parallel_filter(const IntVector *vec, bool (*pred)(int value, void *ctx), void *ctx); // New vector of elements where pred is true, in order (NULL on failure)
+
+// Persistence (binary format of vector_io.h: header, count, checksum; NULL/false and errno on failure)
+bool int_vector_save(const IntVector *vec, const char *path);   // Write vec to path (atomically, via path.tmp)
+IntVector *int_vector_load(const char *path);                   // Read a saved vector into a new heap vector (checksum verified)
+IntVector *int_vector_open_mmap(const char *path, unsigned flags); // Vector backed by the file itself, O(1) to open: VECTOR_MAP_READ_ONLY or VECTOR_MAP_COPY_ON_WRITE, | VECTOR_MAP_VERIFY to check the checksum
+
+// Compression (CompressedIntVector in vector_compressed.h: delta + block bit-packing, read-only)
+CompressedIntVector *int_vector_compress(const IntVector *vec);         // Encode vec (NULL on failure); sorted, dense values take a few bits each
+IntVector *int_vector_decompress(const CompressedIntVector *cv);         // Decode into a new vector (NULL on failure)
+
+// Instrumentation (counts only in a VECTOR_STATS build, see vector_stats.h)
+void int_vector_stats(const IntVector *vec, VectorStats *out);  // Resizes, bytes allocated/copied/shifted, peak and unused capacity of vec
 
 // Utility Operations
 IntVector *int_vector_copy(const IntVector *vec);               // Create a deep copy of vector
@@ -0,0 +1,59 @@
+#ifndef VECTOR_IO_H
+#define VECTOR_IO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "vector_alloc.h"
+
+/*
+ * vector_io - Binary file format for vectors of 32-bit integers
+ *
+ * Layout (little-endian hosts; the byte order is recorded and checked):
+ *
+ *   offset  size
+ *        0     4  magic "IVEC"
+ *        4     4  format version (VECTOR_FILE_VERSION)
+ *        8     4  byte-order mark 0x01020304
+ *       12     4  element size (4)
+ *       16     4  flags (VECTOR_FILE_SORTED)
+ *       20     4  header size (VECTOR_FILE_HEADER_SIZE)
+ *       24     8  element count
+ *       32     8  checksum of the elements (vector_file_checksum)
+ *       40    24  reserved, zero
+ *       64        the elements, count * 4 bytes
+ *
+ * The data starts 64 bytes into the file, so a mapping of the file holds
+ * the elements at a cache-line-aligned address, ready to use in place.
+ * Readers reject other versions, byte orders, element sizes and files
+ * whose size does not match the count.
+ */
+
+#define VECTOR_FILE_VERSION 1
+#define VECTOR_FILE_HEADER_SIZE 64
+#define VECTOR_FILE_SORTED 0x1u         // Elements are in ascending order
+
+// Flags for vector_file_map
+#define VECTOR_MAP_READ_ONLY 0x0u       // Shared read-only mapping: writes to the data crash
+#define VECTOR_MAP_COPY_ON_WRITE 0x1u   // Private mapping: writes stay in memory, the file is unchanged
+#define VECTOR_MAP_VERIFY 0x2u          // Check the checksum (reads the whole file)
+
+typedef struct VectorFileInfo {
+    size_t count;
+    uint32_t flags;
+} VectorFileInfo;
+
+uint64_t vector_file_checksum(const int32_t *data, size_t count);                       // Position-dependent 64-bit checksum
+bool vector_file_save(const char *path, const int32_t *data, size_t count, uint32_t flags); // Write to path.tmp, then rename over path (false + errno on failure)
+const VectorAllocator *vector_file_map(const char *path, unsigned map_flags,
+                                       VectorFileInfo *info, int32_t **data);            // Map a file; NULL + errno on failure (EINVAL: not a valid file)
+
+/*
+ * The allocator returned by vector_file_map owns the mapping: freeing the
+ * data pointer unmaps it, reallocating it moves the data to the heap, and
+ * other requests go to malloc. It frees itself when everything allocated
+ * from it (the mapping included) has been freed, so a vector whose data
+ * is the mapping can simply use it as its allocator.
+ */
+
+#endif /* VECTOR_IO_H */
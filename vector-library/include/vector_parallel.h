@@ -0,0 +1,36 @@
+#ifndef VECTOR_PARALLEL_H
+#define VECTOR_PARALLEL_H
+
+#include <stddef.h>
+
+/*
+ * vector_parallel - Small thread pool behind the int_vector_parallel_*
+ * operations
+ *
+ * Work is cut into chunks of at least the grain size; ranges of fewer
+ * than two grains run serially on the calling thread, so the parallel
+ * functions are safe to call on any vector. The pool starts on first use
+ * with one worker per online CPU (minus the caller, which also works),
+ * or VECTOR_THREADS from the environment. One parallel job runs at a
+ * time: a job started while another one is running (including from
+ * inside a chunk) runs its chunks serially instead of waiting.
+ *
+ * Link with -pthread.
+ */
+
+#define VECTOR_PARALLEL_GRAIN 65536     // Default minimum elements per chunk
+
+typedef void (*VectorChunkFn)(size_t chunk, size_t begin, size_t end, void *ctx);
+
+// Running work
+size_t vector_parallel_chunks(size_t count);                            // Number of chunks vector_parallel_for will cut count elements into
+void vector_parallel_for(size_t count, size_t chunks, VectorChunkFn body, void *ctx); // Call body once per chunk of [0, count), chunk i covering an even share in order; returns when all are done
+
+// Configuration
+void vector_parallel_set_threads(unsigned threads);                     // Threads to use, caller included (0: one per CPU); restarts the pool
+unsigned vector_parallel_threads(void);                                 // Threads in use
+void vector_parallel_set_grain(size_t grain);                           // Minimum elements per chunk (0: VECTOR_PARALLEL_GRAIN)
+size_t vector_parallel_grain(void);                                     // Current grain size
+void vector_parallel_shutdown(void);                                    // Stop and join the workers (restarted on next use; also runs at exit)
+
+#endif /* VECTOR_PARALLEL_H */
@@ -0,0 +1,33 @@
+#ifndef VECTOR_SIMD_H
+#define VECTOR_SIMD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * vector_simd - SIMD kernels for searching and reducing 32-bit elements
+ *
+ * Used by find/contains of every vector whose element type is 4 bytes wide
+ * (IntVector included) and by the IntVector reductions. Kernels:
+ * - avx2:   8 elements per compare (x86 with AVX2, checked at runtime)
+ * - sse2:   4 elements per compare (every x86-64)
+ * - scalar: portable fallback
+ *
+ * The best supported kernel is picked on first use. Set VECTOR_SIMD to
+ * scalar, sse2 or avx2 in the environment to force one.
+ */
+
+// Search (elements are compared bitwise, like memcmp)
+size_t vector_simd_find32(const void *data, size_t count, uint32_t value);    // Index of the first match, or count if none
+size_t vector_simd_count32(const void *data, size_t count, uint32_t value);   // Number of matches
+
+// Reductions over int32_t
+int64_t vector_simd_sum_i32(const int32_t *data, size_t count);               // Sum without overflow (0 if count is 0)
+int32_t vector_simd_min_i32(const int32_t *data, size_t count);               // Smallest element, count must be > 0
+int32_t vector_simd_max_i32(const int32_t *data, size_t count);               // Largest element, count must be > 0
+
+// Kernel selection
+const char *vector_simd_select(const char *name);                             // Use kernel name (best one for NULL/unknown); returns the chosen name
+const char *vector_simd_name(void);                                           // Name of the kernel in use
+
+#endif /* VECTOR_SIMD_H */
@@ -0,0 +1,21 @@
+#ifndef VECTOR_SORT_H
+#define VECTOR_SORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * vector_sort - LSD radix sort for 32-bit integers
+ *
+ * Used by prefix_sort() of ordered vectors whose element type is a 4-byte
+ * integer (IntVector included); every other type goes through the
+ * generic introsort in vector_generic.h. Four counting passes of 8 bits
+ * each, O(n) regardless of the input, and passes in which every key has
+ * the same digit are skipped. Needs count * 4 bytes of scratch memory.
+ */
+
+bool vector_radix_sort_i32(int32_t *data, size_t count);    // Sort ascending; false (data untouched) if scratch memory is unavailable
+bool vector_radix_sort_u32(uint32_t *data, size_t count);   // Same for unsigned keys
+
+#endif /* VECTOR_SORT_H */
@@ -0,0 +1,41 @@
+#ifndef VECTOR_STATS_H
+#define VECTOR_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * VectorStats - Allocation and copy counters (stats build only)
+ *
+ * Built with -DVECTOR_STATS (make STATS=1), every vector counts its own
+ * resizes, bytes allocated, bytes copied to a new block and bytes shifted
+ * by insert/remove, and adds them to process-wide totals. Without it the
+ * counters and the code that updates them do not exist, and the functions
+ * below report zeros. The library and everything that includes its
+ * headers must agree on the flag (it changes the size of the structs).
+ *
+ *   VectorStats s;
+ *   int_vector_stats(vec, &s);
+ *   vector_stats_dump(stderr, "results", &s);
+ */
+
+typedef struct VectorStats {
+    uint64_t resizes;          // Data blocks allocated, reallocated, moved to/from the inline buffer or adopted (mapped files)
+    uint64_t bytes_allocated;  // Sum of the block sizes requested
+    uint64_t bytes_copied;     // Elements copied by resizes (realloc that moved, inline <-> heap)
+    uint64_t bytes_shifted;    // Elements moved within the block by insert/remove and their range forms
+    uint64_t capacity_bytes;   // Heap capacity now (global: of all vectors alive)
+    uint64_t peak_bytes;       // Largest capacity_bytes seen
+    uint64_t wasted_bytes;     // Unused capacity now (global: left unused by released/destroyed vectors)
+} VectorStats;
+
+void vector_stats_global(VectorStats *out);                     // Totals over every vector (zeros without VECTOR_STATS)
+void vector_stats_reset(void);                                  // Zero the totals, keeping the capacity of live vectors (not while other threads resize)
+void vector_stats_dump(FILE *out, const char *label, const VectorStats *stats); // Print one counter per line; NULL stats: the global totals
+
+// Used by the vector implementation in stats builds
+void vector_stats_record_resize_(VectorStats *stats, size_t old_bytes, size_t new_bytes, size_t allocated, size_t copied);
+void vector_stats_record_shift_(VectorStats *stats, size_t bytes);
+void vector_stats_record_release_(VectorStats *stats, size_t capacity_bytes, size_t size_bytes);
+
+#endif /* VECTOR_STATS_H */
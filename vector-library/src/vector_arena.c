@@ -0,0 +1,151 @@
+#include "vector_alloc.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGN 16  // Enough for any scalar type and SSE loads
+
+struct ArenaBlock {
+    struct ArenaBlock *prev;    // Older block, NULL for the first one
+    size_t size;                // Usable bytes in data
+    size_t used;
+    unsigned char data[];
+};
+
+struct VectorArena {
+    struct ArenaBlock *current;
+    size_t block_size;
+    unsigned char *last;        // Most recent allocation, can still grow or be rolled back
+};
+
+
+// Helper functions
+static struct ArenaBlock *arena_new_block(VectorArena *arena, size_t min_size) {
+    size_t size = min_size + ARENA_ALIGN > arena->block_size ? min_size + ARENA_ALIGN : arena->block_size;
+    if (size < min_size) return NULL;  // Overflow
+
+    struct ArenaBlock *block = malloc(sizeof(struct ArenaBlock) + size);
+    if (!block) return NULL;
+
+    block->prev = arena->current;
+    block->size = size;
+    block->used = 0;
+    arena->current = block;
+    return block;
+}
+
+/* Bytes to skip so that data + used is ARENA_ALIGN-aligned */
+static size_t arena_padding(const struct ArenaBlock *block) {
+    uintptr_t at = (uintptr_t)(block->data + block->used);
+    return (size_t)(-at & (ARENA_ALIGN - 1));
+}
+
+static void *arena_alloc(void *ctx, size_t size) {
+    VectorArena *arena = ctx;
+    struct ArenaBlock *block = arena->current;
+
+    if (size == 0) size = 1;  // Every allocation gets a distinct address
+
+    if (block == NULL || arena_padding(block) + size > block->size - block->used) {
+        block = arena_new_block(arena, size);
+        if (!block) return NULL;
+    }
+
+    block->used += arena_padding(block);
+    unsigned char *ptr = block->data + block->used;
+    block->used += size;
+    arena->last = ptr;
+    return ptr;
+}
+
+static void *arena_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+    VectorArena *arena = ctx;
+    struct ArenaBlock *block = arena->current;
+
+    if (ptr == NULL) return arena_alloc(ctx, new_size);
+
+    // The most recent allocation grows or shrinks in place while it fits
+    if (ptr == arena->last) {
+        size_t offset = (size_t)((unsigned char *)ptr - block->data);
+        if (new_size <= block->size - offset) {
+            block->used = offset + (new_size > 0 ? new_size : 1);
+            return ptr;
+        }
+    }
+
+    void *moved = arena_alloc(ctx, new_size);
+    if (!moved) return NULL;
+    memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+    return moved;
+}
+
+static void arena_free(void *ctx, void *ptr, size_t size) {
+    VectorArena *arena = ctx;
+    (void)size;
+
+    // Only the most recent allocation can be given back before a reset
+    if (ptr == arena->last) {
+        arena->current->used = (size_t)((unsigned char *)ptr - arena->current->data);
+        arena->last = NULL;
+    }
+}
+
+
+// Public API
+VectorArena *vector_arena_create(size_t block_size) {
+    VectorArena *arena = malloc(sizeof(VectorArena));
+    if (!arena) return NULL;
+
+    arena->current = NULL;
+    arena->block_size = block_size > 0 ? block_size : DEFAULT_BLOCK_SIZE;
+    arena->last = NULL;
+
+    if (!arena_new_block(arena, 0)) {
+        free(arena);
+        return NULL;
+    }
+    return arena;
+}
+
+void vector_arena_destroy(VectorArena *arena) {
+    assert(arena != NULL);
+
+    struct ArenaBlock *block = arena->current;
+    while (block) {
+        struct ArenaBlock *prev = block->prev;
+        free(block);
+        block = prev;
+    }
+    free(arena);
+}
+
+void vector_arena_reset(VectorArena *arena) {
+    assert(arena != NULL);
+
+    while (arena->current->prev) {
+        struct ArenaBlock *prev = arena->current->prev;
+        free(arena->current);
+        arena->current = prev;
+    }
+    arena->current->used = 0;
+    arena->last = NULL;
+}
+
+size_t vector_arena_used(const VectorArena *arena) {
+    assert(arena != NULL);
+
+    size_t used = 0;
+    for (const struct ArenaBlock *block = arena->current; block; block = block->prev) {
+        used += block->used;
+    }
+    return used;
+}
+
+VectorAllocator vector_arena_allocator(VectorArena *arena) {
+    assert(arena != NULL);
+
+    VectorAllocator allocator = {arena_alloc, arena_realloc, arena_free, arena};
+    return allocator;
+}
@@ -0,0 +1,301 @@
+#include "vector_compressed.h"
+#include "vector_simd.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define LANES 4
+#define ROWS (COMPRESSED_BLOCK_SIZE / LANES)   // Values per lane in a block
+
+/*
+ * Block layout: lane l holds values l, l+4, l+8, ... Each lane is packed
+ * into `width` 32-bit words, and the words of the four lanes are
+ * interleaved (word w of lane l is at w * 4 + l), so one 16-byte load
+ * fetches the same word of every lane.
+ */
+struct CompressedIntVector {
+    size_t size;
+    size_t blocks;
+    bool sorted;                // Differences are plain, not zigzag-encoded
+    int32_t *heads;             // First value of each block
+    uint8_t *widths;            // Bits per difference in each block
+    size_t *offsets;            // Index of each block's first word in words
+    uint32_t *words;
+};
+
+
+// Helper functions
+static uint32_t zigzag(uint32_t d) {
+    return (d << 1) ^ (0u - (d >> 31));
+}
+
+static uint32_t unzigzag(uint32_t z) {
+    return (z >> 1) ^ (0u - (z & 1));
+}
+
+static unsigned bit_width(uint32_t x) {
+    unsigned bits = 0;
+    while (x) {
+        bits++;
+        x >>= 1;
+    }
+    return bits;
+}
+
+/* Differences of one block (padded with its last value) into d */
+static void block_deltas(const int *values, size_t n, bool sorted, uint32_t *d) {
+    uint32_t v[COMPRESSED_BLOCK_SIZE];
+    for (size_t i = 0; i < COMPRESSED_BLOCK_SIZE; i++) {
+        v[i] = (uint32_t)values[i < n ? i : n - 1];
+    }
+    for (size_t i = 0; i < COMPRESSED_BLOCK_SIZE; i++) {
+        uint32_t diff = v[i] - (i < LANES ? v[0] : v[i - LANES]);  // Wraps, and unwraps on decode
+        d[i] = sorted ? diff : zigzag(diff);
+    }
+}
+
+static void pack_block(const uint32_t *d, unsigned width, uint32_t *out) {
+    memset(out, 0, (size_t)width * LANES * sizeof(uint32_t));
+    for (size_t row = 0; row < ROWS; row++) {
+        unsigned bit = (unsigned)row * width;
+        unsigned w = bit / 32, s = bit % 32;
+        for (size_t l = 0; l < LANES; l++) {
+            uint32_t x = d[row * LANES + l];
+            out[w * LANES + l] |= x << s;
+            if (s + width > 32) out[(w + 1) * LANES + l] |= x >> (32 - s);
+        }
+    }
+}
+
+/* The difference at row of lane l */
+static uint32_t unpack_one(const uint32_t *in, unsigned width, size_t row, size_t l) {
+    if (width == 0) return 0;
+    uint32_t mask = width == 32 ? UINT32_MAX : (1u << width) - 1;
+    unsigned bit = (unsigned)row * width;
+    unsigned w = bit / 32, s = bit % 32;
+    uint32_t x = in[w * LANES + l] >> s;
+    if (s + width > 32) x |= in[(w + 1) * LANES + l] << (32 - s);
+    return x & mask;
+}
+
+static void decode_full_block(const CompressedIntVector *cv, size_t block, int *out) {
+    const uint32_t *in = cv->words + cv->offsets[block];
+    unsigned width = cv->widths[block];
+    uint32_t head = (uint32_t)cv->heads[block];
+
+#ifdef __SSE2__
+    const __m128i mask = _mm_set1_epi32(width == 32 ? -1 : (int)((1u << width) - 1));
+    const __m128i one = _mm_set1_epi32(1);
+    __m128i acc = _mm_set1_epi32((int)head);
+    for (size_t row = 0; row < ROWS; row++) {
+        __m128i x = _mm_setzero_si128();
+        if (width > 0) {
+            unsigned bit = (unsigned)row * width;
+            unsigned w = bit / 32, s = bit % 32;
+            x = _mm_srl_epi32(_mm_loadu_si128((const __m128i *)(in + w * LANES)), _mm_cvtsi32_si128((int)s));
+            if (s + width > 32) {
+                __m128i hi = _mm_loadu_si128((const __m128i *)(in + (w + 1) * LANES));
+                x = _mm_or_si128(x, _mm_sll_epi32(hi, _mm_cvtsi32_si128((int)(32 - s))));
+            }
+            x = _mm_and_si128(x, mask);
+        }
+        if (!cv->sorted) {
+            x = _mm_xor_si128(_mm_srli_epi32(x, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(x, one)));
+        }
+        acc = _mm_add_epi32(acc, x);
+        _mm_storeu_si128((__m128i *)(out + row * LANES), acc);
+    }
+#else
+    uint32_t acc[LANES] = {head, head, head, head};
+    for (size_t row = 0; row < ROWS; row++) {
+        for (size_t l = 0; l < LANES; l++) {
+            uint32_t x = unpack_one(in, width, row, l);
+            acc[l] += cv->sorted ? x : unzigzag(x);
+            out[row * LANES + l] = (int)acc[l];
+        }
+    }
+#endif
+}
+
+static size_t block_length(const CompressedIntVector *cv, size_t block) {
+    size_t start = block * COMPRESSED_BLOCK_SIZE;
+    return cv->size - start < COMPRESSED_BLOCK_SIZE ? cv->size - start : COMPRESSED_BLOCK_SIZE;
+}
+
+
+// Creation and Destruction
+CompressedIntVector *compressed_int_vector_create(const int *values, size_t count) {
+    assert(values != NULL || count == 0);
+    CompressedIntVector *cv = calloc(1, sizeof(CompressedIntVector));
+    if (!cv) return NULL;
+
+    cv->size = count;
+    cv->blocks = (count + COMPRESSED_BLOCK_SIZE - 1) / COMPRESSED_BLOCK_SIZE;
+    cv->sorted = true;
+    for (size_t i = 1; i < count && cv->sorted; i++) {
+        cv->sorted = values[i - 1] <= values[i];
+    }
+
+    cv->heads = malloc((cv->blocks + 1) * sizeof(int32_t));
+    cv->widths = malloc(cv->blocks + 1);
+    cv->offsets = malloc((cv->blocks + 1) * sizeof(size_t));
+    if (!cv->heads || !cv->widths || !cv->offsets) {
+        compressed_int_vector_destroy(cv);
+        return NULL;
+    }
+
+    // First pass: the width of each block gives the word offsets
+    uint32_t d[COMPRESSED_BLOCK_SIZE];
+    size_t total = 0;
+    for (size_t b = 0; b < cv->blocks; b++) {
+        size_t start = b * COMPRESSED_BLOCK_SIZE;
+        block_deltas(values + start, block_length(cv, b), cv->sorted, d);
+        uint32_t all = 0;
+        for (size_t i = 0; i < COMPRESSED_BLOCK_SIZE; i++) {
+            all |= d[i];
+        }
+        cv->heads[b] = values[start];
+        cv->widths[b] = (uint8_t)bit_width(all);
+        cv->offsets[b] = total;
+        total += (size_t)cv->widths[b] * LANES;
+    }
+    cv->offsets[cv->blocks] = total;
+
+    // Second pass: pack
+    cv->words = malloc((total > 0 ? total : 1) * sizeof(uint32_t));
+    if (!cv->words) {
+        compressed_int_vector_destroy(cv);
+        return NULL;
+    }
+    for (size_t b = 0; b < cv->blocks; b++) {
+        size_t start = b * COMPRESSED_BLOCK_SIZE;
+        block_deltas(values + start, block_length(cv, b), cv->sorted, d);
+        pack_block(d, cv->widths[b], cv->words + cv->offsets[b]);
+    }
+    return cv;
+}
+
+void compressed_int_vector_destroy(CompressedIntVector *cv) {
+    assert(cv != NULL);
+    free(cv->heads);
+    free(cv->widths);
+    free(cv->offsets);
+    free(cv->words);
+    free(cv);
+}
+
+
+// Accessors
+size_t compressed_int_vector_size(const CompressedIntVector *cv) {
+    assert(cv != NULL);
+    return cv->size;
+}
+
+size_t compressed_int_vector_bytes(const CompressedIntVector *cv) {
+    assert(cv != NULL);
+    return sizeof(CompressedIntVector) +
+           (cv->blocks + 1) * (sizeof(int32_t) + 1 + sizeof(size_t)) +
+           cv->offsets[cv->blocks] * sizeof(uint32_t);
+}
+
+bool compressed_int_vector_is_sorted(const CompressedIntVector *cv) {
+    assert(cv != NULL);
+    return cv->sorted;
+}
+
+/* Only the lane of index is summed, up to its row */
+int compressed_int_vector_get(const CompressedIntVector *cv, size_t index) {
+    assert(cv != NULL);
+    assert(index < cv->size);
+    size_t block = index / COMPRESSED_BLOCK_SIZE;
+    size_t i = index % COMPRESSED_BLOCK_SIZE;
+    const uint32_t *in = cv->words + cv->offsets[block];
+    unsigned width = cv->widths[block];
+
+    uint32_t value = (uint32_t)cv->heads[block];
+    for (size_t row = 0; row <= i / LANES; row++) {
+        uint32_t x = unpack_one(in, width, row, i % LANES);
+        value += cv->sorted ? x : unzigzag(x);
+    }
+    return (int)value;
+}
+
+
+// Decoding
+size_t compressed_int_vector_blocks(const CompressedIntVector *cv) {
+    assert(cv != NULL);
+    return cv->blocks;
+}
+
+size_t compressed_int_vector_decode_block(const CompressedIntVector *cv, size_t block, int *out) {
+    assert(cv != NULL);
+    assert(block < cv->blocks);
+    assert(out != NULL);
+    decode_full_block(cv, block, out);
+    return block_length(cv, block);
+}
+
+void compressed_int_vector_decode(const CompressedIntVector *cv, int *out) {
+    assert(cv != NULL);
+    assert(out != NULL || cv->size == 0);
+    size_t full = cv->size / COMPRESSED_BLOCK_SIZE;
+    for (size_t b = 0; b < full; b++) {
+        decode_full_block(cv, b, out + b * COMPRESSED_BLOCK_SIZE);
+    }
+    if (full < cv->blocks) {
+        // The last block is padded: decode it aside
+        int tail[COMPRESSED_BLOCK_SIZE];
+        decode_full_block(cv, full, tail);
+        memcpy(out + full * COMPRESSED_BLOCK_SIZE, tail, block_length(cv, full) * sizeof(int));
+    }
+}
+
+
+// Search
+size_t compressed_int_vector_lower_bound(const CompressedIntVector *cv, int value) {
+    assert(cv != NULL);
+    assert(cv->sorted);
+    if (cv->size == 0 || value <= cv->heads[0]) return 0;
+
+    // Last block whose head is below value: the answer is in it or right after it
+    size_t lo = 0, hi = cv->blocks;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (cv->heads[mid] < value) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    int block[COMPRESSED_BLOCK_SIZE];
+    size_t n = compressed_int_vector_decode_block(cv, lo, block);
+    size_t i = 0;
+    while (i < n && block[i] < value) i++;
+    return lo * COMPRESSED_BLOCK_SIZE + i;
+}
+
+int compressed_int_vector_find(const CompressedIntVector *cv, int value) {
+    assert(cv != NULL);
+    if (cv->sorted) {
+        size_t i = compressed_int_vector_lower_bound(cv, value);
+        return i < cv->size && compressed_int_vector_get(cv, i) == value ? (int)i : -1;
+    }
+
+    int block[COMPRESSED_BLOCK_SIZE];
+    for (size_t b = 0; b < cv->blocks; b++) {
+        size_t n = compressed_int_vector_decode_block(cv, b, block);
+        size_t i = vector_simd_find32(block, n, (uint32_t)value);
+        if (i < n) return (int)(b * COMPRESSED_BLOCK_SIZE + i);
+    }
+    return -1;
+}
+
+bool compressed_int_vector_contains(const CompressedIntVector *cv, int value) {
+    return compressed_int_vector_find(cv, value) != -1;
+}
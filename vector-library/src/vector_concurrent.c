@@ -0,0 +1,202 @@
+#include "vector_concurrent.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef __GNUC__
+#error "vector_concurrent.c needs the GCC/Clang __atomic builtins"
+#endif
+
+#define FIRST_SEGMENT_BITS 10   // The first segment holds 1024 elements
+#define FIRST_SEGMENT ((size_t)1 << FIRST_SEGMENT_BITS)
+#define MAX_SEGMENTS (sizeof(size_t) * 8 - FIRST_SEGMENT_BITS)
+#define CACHE_LINE 64
+
+/*
+ * Segment k holds FIRST_SEGMENT << k elements, so element i lives in the
+ * segment given by the highest set bit of i + FIRST_SEGMENT. Each segment
+ * is followed by a bitmap with one bit per slot, set once the slot has been
+ * written. published is the end of the run of set bits from slot 0: every
+ * slot below it is written. The two counters sit on their own cache lines:
+ * every append touches both.
+ */
+struct ConcurrentIntVector {
+    size_t reserved;            // Slots handed out by push/append
+    char pad1[CACHE_LINE - sizeof(size_t)];
+    size_t published;           // Slots [0, published) are all written
+    char pad2[CACHE_LINE - sizeof(size_t)];
+    int *segments[MAX_SEGMENTS];
+};
+
+
+// Helper functions
+static unsigned segment_of(size_t index, size_t *offset) {
+    unsigned long long slot = (unsigned long long)index + FIRST_SEGMENT;
+    unsigned top = 63u - (unsigned)__builtin_clzll(slot);
+    *offset = (size_t)(slot - (1ull << top));
+    return top - FIRST_SEGMENT_BITS;
+}
+
+static size_t segment_length(unsigned k) {
+    return FIRST_SEGMENT << k;
+}
+
+/* The written-slot bitmap stored after the elements of segment k */
+static uint64_t *ready_bits(int *seg, unsigned k) {
+    return (uint64_t *)(seg + segment_length(k));
+}
+
+/* Segment k, allocated by whichever thread gets there first */
+static int *segment(ConcurrentIntVector *cv, unsigned k) {
+    int *seg = __atomic_load_n(&cv->segments[k], __ATOMIC_ACQUIRE);
+    if (seg) return seg;
+
+    size_t words = segment_length(k) / 64;
+    int *fresh = malloc(segment_length(k) * sizeof(int) + words * sizeof(uint64_t));
+    assert(fresh != NULL);
+    if (!fresh) abort();
+    memset(ready_bits(fresh, k), 0, words * sizeof(uint64_t));
+    if (__atomic_compare_exchange_n(&cv->segments[k], &seg, fresh, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        return fresh;
+    }
+    free(fresh);  // Another thread won; seg now holds its segment
+    return seg;
+}
+
+/* Set the written bits of slots [first, first + count) */
+static void mark_written(ConcurrentIntVector *cv, size_t first, size_t count) {
+    size_t index = first;
+    while (index < first + count) {
+        size_t offset;
+        unsigned k = segment_of(index, &offset);
+        unsigned bit = (unsigned)(offset % 64);
+        size_t n = 64 - bit;
+        if (n > first + count - index) n = first + count - index;
+        uint64_t mask = (n == 64 ? ~0ull : ((1ull << n) - 1)) << bit;
+        int *seg = __atomic_load_n(&cv->segments[k], __ATOMIC_RELAXED);  // Allocated by this append
+        __atomic_fetch_or(&ready_bits(seg, k)[offset / 64], mask, __ATOMIC_SEQ_CST);
+        index += n;
+    }
+}
+
+/* End of the run of written slots that starts at index */
+static size_t written_end(const ConcurrentIntVector *cv, size_t index) {
+    for (;;) {
+        size_t offset;
+        unsigned k = segment_of(index, &offset);
+        int *seg = __atomic_load_n(&cv->segments[k], __ATOMIC_ACQUIRE);
+        if (!seg) return index;
+
+        unsigned bit = (unsigned)(offset % 64);
+        uint64_t word = __atomic_load_n(&ready_bits(seg, k)[offset / 64], __ATOMIC_SEQ_CST);
+        uint64_t holes = ~(word >> bit);
+        unsigned run = holes ? (unsigned)__builtin_ctzll(holes) : 64;
+        if (run < 64 - bit) return index + run;
+        index += 64 - bit;
+    }
+}
+
+/*
+ * Move published to the end of the written run. Called by every append
+ * after it has marked its slots: an append that finds a hole below its
+ * slots stops at once and leaves the rest to the append that owns the
+ * hole. Marks and scans are sequentially consistent, so of two appends
+ * finishing together at least one sees the other's slots; the last one
+ * to finish therefore publishes everything.
+ */
+static void publish(ConcurrentIntVector *cv) {
+    size_t from = __atomic_load_n(&cv->published, __ATOMIC_ACQUIRE);
+    for (;;) {
+        size_t to = written_end(cv, from);
+        if (to == from) return;
+        if (__atomic_compare_exchange_n(&cv->published, &from, to, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            from = to;  // Look again: appends may have finished past it meanwhile
+        }
+    }
+}
+
+// Creation and Destruction
+ConcurrentIntVector *concurrent_int_vector_create(void) {
+    return calloc(1, sizeof(ConcurrentIntVector));
+}
+
+void concurrent_int_vector_destroy(ConcurrentIntVector *cv) {
+    assert(cv != NULL);
+    for (unsigned k = 0; k < MAX_SEGMENTS; k++) {
+        free(cv->segments[k]);
+    }
+    free(cv);
+}
+
+IntVector *concurrent_int_vector_freeze(ConcurrentIntVector *cv) {
+    assert(cv != NULL);
+    assert(__atomic_load_n(&cv->published, __ATOMIC_ACQUIRE) ==
+           __atomic_load_n(&cv->reserved, __ATOMIC_ACQUIRE));  // Writers must be done
+    IntVector *vec = concurrent_int_vector_snapshot(cv);
+    if (vec) concurrent_int_vector_destroy(cv);
+    return vec;
+}
+
+
+// Appending
+size_t concurrent_int_vector_push(ConcurrentIntVector *cv, int value) {
+    return concurrent_int_vector_append(cv, &value, 1);
+}
+
+size_t concurrent_int_vector_append(ConcurrentIntVector *cv, const int *values, size_t count) {
+    assert(cv != NULL);
+    assert(values != NULL || count == 0);
+    size_t first = __atomic_fetch_add(&cv->reserved, count, __ATOMIC_RELAXED);
+
+    size_t index = first;
+    while (index < first + count) {
+        size_t offset;
+        unsigned k = segment_of(index, &offset);
+        size_t n = segment_length(k) - offset;
+        if (n > first + count - index) n = first + count - index;
+        memcpy(segment(cv, k) + offset, values + (index - first), n * sizeof(int));
+        index += n;
+    }
+
+    mark_written(cv, first, count);
+    publish(cv);
+    return first;
+}
+
+
+// Reading
+int concurrent_int_vector_get(const ConcurrentIntVector *cv, size_t index) {
+    assert(cv != NULL);
+    assert(index < __atomic_load_n(&cv->reserved, __ATOMIC_RELAXED));
+    size_t offset;
+    unsigned k = segment_of(index, &offset);
+    return __atomic_load_n(&cv->segments[k], __ATOMIC_ACQUIRE)[offset];
+}
+
+size_t concurrent_int_vector_size(const ConcurrentIntVector *cv) {
+    assert(cv != NULL);
+    return __atomic_load_n(&cv->published, __ATOMIC_ACQUIRE);
+}
+
+IntVector *concurrent_int_vector_snapshot(const ConcurrentIntVector *cv) {
+    assert(cv != NULL);
+    size_t n = __atomic_load_n(&cv->published, __ATOMIC_ACQUIRE);
+    IntVector *vec = int_vector_create(n);
+    if (!vec) return NULL;
+
+    // Appended segment by segment: one copy, straight from the segments
+    size_t index = 0;
+    while (index < n) {
+        size_t offset;
+        unsigned k = segment_of(index, &offset);
+        size_t len = segment_length(k) - offset;
+        if (len > n - index) len = n - index;
+        int_vector_append(vec, __atomic_load_n(&cv->segments[k], __ATOMIC_ACQUIRE) + offset, len);
+        index += len;
+    }
+    return vec;
+}
@@ -0,0 +1,232 @@
+#include "vector_deque.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#define DEQUE_DEFAULT_SIZE 8
+
+struct IntDeque {
+    int *data;
+    size_t head;                // Buffer index of the front element
+    size_t size;
+    size_t capacity;            // Power of two
+    const VectorAllocator *allocator;  // NULL: malloc/realloc/free
+};
+
+
+// Helper functions
+static size_t round_up_pow2(size_t n) {
+    size_t cap = DEQUE_DEFAULT_SIZE;
+    while (cap < n) {
+        if (cap > SIZE_MAX / 2) return 0;
+        cap *= 2;
+    }
+    return cap;
+}
+
+/* Buffer index of the element index positions from the front */
+static size_t slot(const IntDeque *dq, size_t index) {
+    return (dq->head + index) & (dq->capacity - 1);
+}
+
+/*
+ * Reallocate to new_capacity (a larger power of two). realloc keeps the
+ * buffer as it was; if the elements wrapped, the part that wrapped is
+ * moved up behind the rest, which is now followed by free space.
+ */
+static bool deque_resize(IntDeque *dq, size_t new_capacity) {
+    assert(new_capacity > dq->capacity);
+    if (new_capacity > SIZE_MAX / sizeof(int)) return false;
+
+    int *new_data = vector_mem_realloc(dq->allocator, dq->data, dq->capacity * sizeof(int),
+                                       new_capacity * sizeof(int));
+    if (!new_data) return false;
+
+    if (dq->head + dq->size > dq->capacity) {
+        size_t wrapped = dq->head + dq->size - dq->capacity;
+        memcpy(new_data + dq->capacity, new_data, wrapped * sizeof(int));
+    }
+    dq->data = new_data;
+    dq->capacity = new_capacity;
+    return true;
+}
+
+static void deque_grow(IntDeque *dq, size_t min_capacity) {
+    size_t new_cap = round_up_pow2(min_capacity);
+    bool success = new_cap != 0 && deque_resize(dq, new_cap);
+    assert(success);
+    (void)success;
+}
+
+static void reverse(int *data, size_t count) {
+    for (size_t i = 0, j = count; i + 1 < j; i++, j--) {
+        int tmp = data[i];
+        data[i] = data[j - 1];
+        data[j - 1] = tmp;
+    }
+}
+
+
+// Creation and Destruction
+IntDeque *int_deque_create_with(size_t initial_capacity, const VectorAllocator *allocator) {
+    size_t cap = round_up_pow2(initial_capacity);
+    if (cap == 0 || cap > SIZE_MAX / sizeof(int)) return NULL;
+
+    IntDeque *dq = vector_mem_alloc(allocator, sizeof(IntDeque));
+    if (!dq) return NULL;
+
+    dq->data = vector_mem_alloc(allocator, cap * sizeof(int));
+    if (!dq->data) {
+        vector_mem_free(allocator, dq, sizeof(IntDeque));
+        return NULL;
+    }
+    dq->head = 0;
+    dq->size = 0;
+    dq->capacity = cap;
+    dq->allocator = allocator;
+    return dq;
+}
+
+IntDeque *int_deque_create(size_t initial_capacity) {
+    return int_deque_create_with(initial_capacity, NULL);
+}
+
+void int_deque_destroy(IntDeque *dq) {
+    assert(dq != NULL);
+    vector_mem_free(dq->allocator, dq->data, dq->capacity * sizeof(int));
+    vector_mem_free(dq->allocator, dq, sizeof(IntDeque));
+}
+
+void int_deque_clear(IntDeque *dq) {
+    assert(dq != NULL);
+    dq->head = 0;
+    dq->size = 0;
+}
+
+
+// Basic Operations
+void int_deque_push_back(IntDeque *dq, int value) {
+    assert(dq != NULL);
+    if (dq->size == dq->capacity) {
+        deque_grow(dq, dq->size + 1);
+    }
+    dq->data[slot(dq, dq->size)] = value;
+    dq->size++;
+}
+
+void int_deque_push_front(IntDeque *dq, int value) {
+    assert(dq != NULL);
+    if (dq->size == dq->capacity) {
+        deque_grow(dq, dq->size + 1);
+    }
+    dq->head = (dq->head - 1) & (dq->capacity - 1);
+    dq->data[dq->head] = value;
+    dq->size++;
+}
+
+int int_deque_pop_back(IntDeque *dq) {
+    assert(dq != NULL);
+    assert(dq->size != 0);
+    dq->size--;
+    return dq->data[slot(dq, dq->size)];
+}
+
+int int_deque_pop_front(IntDeque *dq) {
+    assert(dq != NULL);
+    assert(dq->size != 0);
+    int value = dq->data[dq->head];
+    dq->head = (dq->head + 1) & (dq->capacity - 1);
+    dq->size--;
+    return value;
+}
+
+void int_deque_append(IntDeque *dq, const int *values, size_t count) {
+    assert(dq != NULL);
+    assert(values != NULL || count == 0);
+    if (count == 0) return;
+    if (count > dq->capacity - dq->size) {
+        assert(count <= SIZE_MAX - dq->size);
+        deque_grow(dq, dq->size + count);
+    }
+
+    // Up to the end of the buffer, then the rest from its start
+    size_t tail = slot(dq, dq->size);
+    size_t first = dq->capacity - tail < count ? dq->capacity - tail : count;
+    memcpy(dq->data + tail, values, first * sizeof(int));
+    memcpy(dq->data, values + first, (count - first) * sizeof(int));
+    dq->size += count;
+}
+
+
+// Accessors
+int int_deque_front(const IntDeque *dq) {
+    assert(dq != NULL);
+    assert(dq->size != 0);
+    return dq->data[dq->head];
+}
+
+int int_deque_back(const IntDeque *dq) {
+    assert(dq != NULL);
+    assert(dq->size != 0);
+    return dq->data[slot(dq, dq->size - 1)];
+}
+
+int int_deque_get(const IntDeque *dq, size_t index) {
+    assert(dq != NULL);
+    assert(index < dq->size);
+    return dq->data[slot(dq, index)];
+}
+
+void int_deque_set(IntDeque *dq, size_t index, int value) {
+    assert(dq != NULL);
+    assert(index < dq->size);
+    dq->data[slot(dq, index)] = value;
+}
+
+size_t int_deque_size(const IntDeque *dq) {
+    assert(dq != NULL);
+    return dq->size;
+}
+
+size_t int_deque_capacity(const IntDeque *dq) {
+    assert(dq != NULL);
+    return dq->capacity;
+}
+
+bool int_deque_is_empty(const IntDeque *dq) {
+    assert(dq != NULL);
+    return dq->size == 0;
+}
+
+
+// Memory Management and Bulk Access
+void int_deque_reserve(IntDeque *dq, size_t new_capacity) {
+    assert(dq != NULL);
+    if (new_capacity > dq->capacity) {
+        deque_grow(dq, new_capacity);
+    }
+}
+
+int *int_deque_linearize(IntDeque *dq) {
+    assert(dq != NULL);
+
+    if (dq->head + dq->size > dq->capacity) {
+        // Rotate the whole buffer left by head: [B gap A] becomes [A B gap]
+        reverse(dq->data, dq->head);
+        reverse(dq->data + dq->head, dq->capacity - dq->head);
+        reverse(dq->data, dq->capacity);
+        dq->head = 0;
+    }
+    return dq->data + dq->head;
+}
+
+IntVector *int_deque_to_vector(const IntDeque *dq) {
+    assert(dq != NULL);
+    IntVector *vec = int_vector_create(dq->size);
+    if (!vec) return NULL;
+
+    size_t first = dq->capacity - dq->head < dq->size ? dq->capacity - dq->head : dq->size;
+    int_vector_append(vec, dq->data + dq->head, first);
+    int_vector_append(vec, dq->data, dq->size - first);
+    return vec;
+}
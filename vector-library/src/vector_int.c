@@ -1,244 +1,424 @@
 #include "vector_int.h"
-#include <assert.h>
-#include <stdlib.h>
-#include <stdbool.h>
+#include "vector_generic.h"
+#include "vector_io.h"
+#include "vector_parallel.h"
+#include "vector_simd.h"
+#include "vector_sort.h"
+#include <limits.h>
 
-#define GROWTH_FACTOR 2
-#define DEFAULT_SIZE 8
-
-struct IntVector {
-    int *data;
-    size_t size;
-    size_t capacity;
-};
+/*
+ * IntVector is the int instantiation of the generic vector; the contracts
+ * are documented in vector_int.h, the implementation is in vector_generic.h.
+ */
+VECTOR_DEFINE_ORDERED(IntVector, int_vector, int);
 
+// The SIMD reductions treat the data as int32_t
+#if INT_MAX != INT32_MAX
+#error "IntVector reductions assume a 32-bit int"
+#endif
 
-// Helper functions
-static bool int_vector_resize(IntVector *vec, size_t new_capacity) {
-    assert(vec != NULL);
-    assert(new_capacity >= vec->size);  // Can't shrink smaller than current size
-    
-    // Handle zero capacity case
-    if (new_capacity == 0) {
-        free(vec->data);
-        vec->data = NULL;
-        vec->capacity = 0;
-        return true;
-    }
-    
-    int* new_data = realloc(vec->data, new_capacity * sizeof(int));
-    if (!new_data) {
-        return false;
-    }
-    
-    vec->data = new_data;
-    vec->capacity = new_capacity;
-    return true;
-}
+// IntVectorStorage must hold the struct (which has the same inline buffer)
+typedef char int_vector_storage_fits[sizeof(IntVector) <= sizeof(IntVectorStorage) &&
+                                     VECTOR_INLINE_CAPACITY(int) == INT_VECTOR_INLINE_CAPACITY ? 1 : -1];
 
 
 // Creation and Destruction
-IntVector *int_vector_create(size_t initial_capacity) {
-    IntVector *vec = malloc(sizeof(IntVector));
-    if (!vec) return NULL;
+IntVector *int_vector_init_storage(IntVectorStorage *storage, const VectorAllocator *allocator) {
+    assert(storage != NULL);
+    return int_vector_init((IntVector *)storage, allocator);
+}
 
-    size_t cap = initial_capacity > 0 ? initial_capacity : DEFAULT_SIZE;
-    vec->data = malloc(cap * sizeof(int));
-    if (!vec->data) {
-        free(vec);
-        return NULL;
-    }
 
-    vec->size = 0;
-    vec->capacity = cap;
-    return vec;
+// Search Operations
+size_t int_vector_count_equal(const IntVector *vec, int value) {
+    assert(vec != NULL);
+    return vector_simd_count32(vec->data, vec->size, (uint32_t)value);
 }
 
-void int_vector_destroy(IntVector *vec) {
+
+// Reductions
+int64_t int_vector_sum(const IntVector *vec) {
     assert(vec != NULL);
-    free(vec->data);
-    free(vec);
+    return vector_simd_sum_i32((const int32_t *)vec->data, vec->size);
 }
 
-void int_vector_clear(IntVector *vec) {
+int int_vector_min(const IntVector *vec) {
     assert(vec != NULL);
-    vec->size = 0;
+    assert(vec->size != 0);
+    return vector_simd_min_i32((const int32_t *)vec->data, vec->size);
 }
 
-
-// Basic Operations
-void int_vector_push(IntVector *vec, int value) {
+int int_vector_max(const IntVector *vec) {
     assert(vec != NULL);
+    assert(vec->size != 0);
+    return vector_simd_max_i32((const int32_t *)vec->data, vec->size);
+}
 
-     // Resize if needed (amortized O(1))
-    if (vec->size == vec->capacity) {
-        size_t new_cap = vec->capacity == 0 ? DEFAULT_SIZE : vec->capacity * GROWTH_FACTOR;
-        bool success = int_vector_resize(vec, new_cap);
-        assert(success); // Crash if resize fails
-    }
+// Two vectorized passes (value, then first position) beat one scalar pass
+size_t int_vector_min_index(const IntVector *vec) {
+    return vector_simd_find32(vec->data, vec->size, (uint32_t)int_vector_min(vec));
+}
 
-    vec->data[vec->size++] = value;
+size_t int_vector_max_index(const IntVector *vec) {
+    return vector_simd_find32(vec->data, vec->size, (uint32_t)int_vector_max(vec));
 }
 
-int int_vector_pop(IntVector *vec) {
-    assert(vec != NULL);
-    assert(vec->size != 0);
-    return vec->data[--vec->size];
+
+// Parallel Operations
+struct parallel_ctx {
+    int *data;
+    int *out;
+    size_t count;
+    int64_t *partial;           // One result per chunk
+    int64_t identity;
+    int64_t (*op)(int64_t acc, int64_t value);
+    int (*fn)(int value, void *ctx);
+    bool (*pred)(int value, void *ctx);
+    void *user;
+};
+
+static void sum_chunk(size_t chunk, size_t begin, size_t end, void *arg) {
+    struct parallel_ctx *p = arg;
+    p->partial[chunk] = vector_simd_sum_i32((const int32_t *)p->data + begin, end - begin);
 }
 
-void int_vector_insert(IntVector *vec, size_t index, int value) {
-    assert(vec != NULL);
-    assert(index <= vec->size);  // Can insert at end (size), but not beyond
-    
-    // Ensure capacity
-    if (vec->size == vec->capacity) {
-        size_t new_cap = vec->capacity == 0 ? DEFAULT_SIZE : vec->capacity * GROWTH_FACTOR;
-        bool success = int_vector_resize(vec, new_cap);
-        assert(success);
-    }
-    
-    // Shift elements right to make space
-    for (size_t i = vec->size; i > index; i--) {
-        vec->data[i] = vec->data[i - 1];
-    }
-    
-    // Insert new value
-    vec->data[index] = value;
-    vec->size++;
-}
-
-void int_vector_remove(IntVector *vec, size_t index) {
+int64_t int_vector_parallel_sum(const IntVector *vec) {
     assert(vec != NULL);
-    assert(index < vec->size);  // Must be valid index
-    
-    // Shift elements left to fill gap
-    for (size_t i = index; i < vec->size - 1; i++) {
-        vec->data[i] = vec->data[i + 1];
+    size_t chunks = vector_parallel_chunks(vec->size);
+    if (chunks == 1) return int_vector_sum(vec);
+
+    int64_t *partial = malloc(chunks * sizeof(int64_t));
+    if (!partial) return int_vector_sum(vec);
+    struct parallel_ctx p = {vec->data, NULL, vec->size, partial, 0, NULL, NULL, NULL, NULL};
+    vector_parallel_for(vec->size, chunks, sum_chunk, &p);
+
+    int64_t sum = 0;
+    for (size_t i = 0; i < chunks; i++) {
+        sum += partial[i];
     }
-    
-    vec->size--;
+    free(partial);
+    return sum;
 }
 
+static void reduce_chunk(size_t chunk, size_t begin, size_t end, void *arg) {
+    struct parallel_ctx *p = arg;
+    int64_t acc = p->identity;
+    for (size_t i = begin; i < end; i++) {
+        acc = p->op(acc, p->data[i]);
+    }
+    p->partial[chunk] = acc;
+}
 
-// Accessors
-int int_vector_get(const IntVector* vec, size_t index) {
+int64_t int_vector_parallel_reduce(const IntVector *vec, int64_t identity,
+                                   int64_t (*op)(int64_t acc, int64_t value)) {
     assert(vec != NULL);
-    assert(index < vec->size); // Bounds check
-    return vec->data[index];
+    assert(op != NULL);
+    size_t chunks = vector_parallel_chunks(vec->size);
+    int64_t single;
+    int64_t *partial = chunks > 1 ? malloc(chunks * sizeof(int64_t)) : NULL;
+    if (!partial) {
+        chunks = 1;
+        partial = &single;
+    }
+
+    struct parallel_ctx p = {vec->data, NULL, vec->size, partial, identity, op, NULL, NULL, NULL};
+    vector_parallel_for(vec->size, chunks, reduce_chunk, &p);
+
+    int64_t acc = partial[0];
+    for (size_t i = 1; i < chunks; i++) {
+        acc = op(acc, partial[i]);
+    }
+    if (partial != &single) free(partial);
+    return acc;
 }
 
-void int_vector_set(IntVector *vec, size_t index, int value) {
-    assert(vec != NULL);
-    assert(index < vec->size);  // Bounds check
-    vec->data[index] = value;
+static void transform_chunk(size_t chunk, size_t begin, size_t end, void *arg) {
+    struct parallel_ctx *p = arg;
+    (void)chunk;
+    for (size_t i = begin; i < end; i++) {
+        p->data[i] = p->fn(p->data[i], p->user);
+    }
 }
 
-size_t int_vector_size(const IntVector *vec) {
+void int_vector_parallel_transform(IntVector *vec, int (*fn)(int value, void *ctx), void *ctx) {
     assert(vec != NULL);
-    return vec->size;
+    assert(fn != NULL);
+    struct parallel_ctx p = {vec->data, NULL, vec->size, NULL, 0, NULL, fn, NULL, ctx};
+    vector_parallel_for(vec->size, vector_parallel_chunks(vec->size), transform_chunk, &p);
+    vec->sorted = false;
 }
 
-size_t int_vector_capacity(const IntVector *vec) {
-    assert(vec != NULL);
-    return vec->capacity;
+/* Prefix sums wrap around like unsigned arithmetic instead of overflowing */
+static void chunk_total(size_t chunk, size_t begin, size_t end, void *arg) {
+    struct parallel_ctx *p = arg;
+    unsigned total = 0;
+    for (size_t i = begin; i < end; i++) {
+        total += (unsigned)p->data[i];
+    }
+    p->partial[chunk] = total;
 }
 
-bool int_vector_is_empty(const IntVector *vec) {
-    assert(vec != NULL);
-    return vec->size == 0;
+static void scan_chunk(size_t chunk, size_t begin, size_t end, void *arg) {
+    struct parallel_ctx *p = arg;
+    unsigned running = (unsigned)p->partial[chunk];
+    for (size_t i = begin; i < end; i++) {
+        running += (unsigned)p->data[i];
+        p->data[i] = (int)running;
+    }
 }
 
-bool int_vector_is_full(const IntVector *vec) {
+void int_vector_parallel_prefix_sum(IntVector *vec) {
     assert(vec != NULL);
-    return vec->size == vec->capacity;
+    size_t chunks = vector_parallel_chunks(vec->size);
+    int64_t single = 0;
+    int64_t *partial = chunks > 1 ? malloc(chunks * sizeof(int64_t)) : NULL;
+    if (!partial) {
+        chunks = 1;
+        partial = &single;
+    }
+    struct parallel_ctx p = {vec->data, NULL, vec->size, partial, 0, NULL, NULL, NULL, NULL};
+
+    // Totals per chunk, their exclusive scan as each chunk's start, then the scans
+    if (chunks > 1) {
+        vector_parallel_for(vec->size, chunks, chunk_total, &p);
+        unsigned offset = 0;
+        for (size_t i = 0; i < chunks; i++) {
+            unsigned total = (unsigned)partial[i];
+            partial[i] = offset;
+            offset += total;
+        }
+    }
+    vector_parallel_for(vec->size, chunks, scan_chunk, &p);
+
+    if (partial != &single) free(partial);
+    vec->sorted = false;
 }
 
+/* Each chunk compacts its matches to the start of its own slice of out */
+static void filter_chunk(size_t chunk, size_t begin, size_t end, void *arg) {
+    struct parallel_ctx *p = arg;
+    size_t kept = begin;
+    for (size_t i = begin; i < end; i++) {
+        if (p->pred(p->data[i], p->user)) {
+            p->out[kept++] = p->data[i];
+        }
+    }
+    p->partial[chunk] = (int64_t)(kept - begin);
+}
 
-// Memory Management
-void int_vector_reserve(IntVector *vec, size_t new_capacity) {
+IntVector *int_vector_parallel_filter(const IntVector *vec, bool (*pred)(int value, void *ctx), void *ctx) {
     assert(vec != NULL);
-    if (new_capacity > vec->capacity) {
-        bool success = int_vector_resize(vec, new_capacity);
-        assert(success);
+    assert(pred != NULL);
+    size_t chunks = vector_parallel_chunks(vec->size);
+    int64_t single;
+    int64_t *partial = chunks > 1 ? malloc(chunks * sizeof(int64_t)) : NULL;
+    if (!partial) {
+        chunks = 1;
+        partial = &single;
+    }
+
+    IntVector *out = int_vector_create_with(vec->size, vec->allocator);
+    if (out) {
+        struct parallel_ctx p = {vec->data, out->data, vec->size, partial, 0, NULL, NULL, pred, ctx};
+        vector_parallel_for(vec->size, chunks, filter_chunk, &p);
+
+        // Close the gaps between the slices, in order
+        size_t size = 0;
+        for (size_t i = 0; i < chunks; i++) {
+            size_t begin = i * (vec->size / chunks) + (i < vec->size % chunks ? i : vec->size % chunks);
+            size_t kept = (size_t)partial[i];
+            memmove(out->data + size, out->data + begin, kept * sizeof(int));
+            size += kept;
+        }
+        out->size = size;
+        out->sorted = vec->sorted;
+        int_vector_shrink_to_fit(out);
     }
+
+    if (partial != &single) free(partial);
+    return out;
 }
 
-void int_vector_shrink_to_fit(IntVector *vec) {
-    assert(vec != NULL);
-    if (vec->size < vec->capacity) {
-        bool success = int_vector_resize(vec, vec->size);
-        assert(success);
+/* Sort one run: radix sort, or introsort if scratch memory is short */
+static void sort_ints(int *data, size_t count) {
+    if (!vector_radix_sort_i32((int32_t *)data, count)) {
+        unsigned depth = 0;
+        for (size_t m = count; m > 1; m >>= 1) depth += 2;
+        int_vector_introsort_(data, count, depth);
     }
 }
 
+/* Number of elements of a (na) among the first k of the stable merge of a and b */
+static size_t merge_split(const int *a, size_t na, const int *b, size_t nb, size_t k) {
+    size_t lo = k > nb ? k - nb : 0;
+    size_t hi = k < na ? k : na;
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        if (b[k - i - 1] >= a[i]) {
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+    return lo;
+}
 
-// Search Operations
-int int_vector_find(const IntVector *vec, int value) {
+struct merge_ctx {
+    const int *src;
+    int *dst;
+    const size_t *bounds;       // runs + 1 run boundaries
+    size_t runs;
+};
+
+static void sort_chunk(size_t chunk, size_t begin, size_t end, void *arg) {
+    struct merge_ctx *m = arg;
+    (void)chunk;
+    sort_ints(m->dst + begin, end - begin);
+}
+
+/* Writes output positions [begin, end) of one merge round: every pair of
+ * runs that overlaps them is split where the output slice starts and ends */
+static void merge_chunk(size_t chunk, size_t begin, size_t end, void *arg) {
+    struct merge_ctx *m = arg;
+    (void)chunk;
+    for (size_t r = 0; r < m->runs; r += 2) {
+        size_t start = m->bounds[r];
+        size_t mid = m->bounds[r + 1];
+        size_t stop = m->bounds[r + 2 <= m->runs ? r + 2 : r + 1];
+        if (stop <= begin || start >= end) continue;
+
+        const int *a = m->src + start, *b = m->src + mid;
+        size_t na = mid - start, nb = stop - mid;
+        size_t from = (begin > start ? begin : start) - start;
+        size_t to = (end < stop ? end : stop) - start;
+        size_t i = merge_split(a, na, b, nb, from), j = from - i;
+        size_t i_end = merge_split(a, na, b, nb, to), j_end = to - i_end;
+
+        int *out = m->dst + start + from;
+        while (i < i_end && j < j_end) {
+            *out++ = b[j] < a[i] ? b[j++] : a[i++];
+        }
+        while (i < i_end) *out++ = a[i++];
+        while (j < j_end) *out++ = b[j++];
+    }
+}
+
+void int_vector_parallel_sort(IntVector *vec) {
     assert(vec != NULL);
-    
-    for (size_t i = 0; i < vec->size; i++) {
-        if (vec->data[i] == value) {
-            return (int)i;  // Found - return index
+    size_t n = vec->size;
+    size_t chunks = vector_parallel_chunks(n);
+    if (chunks == 1 || vec->sorted || int_vector_sorted_range_(vec->data, n)) {
+        int_vector_sort(vec);
+        return;
+    }
+
+    int *scratch = malloc(n * sizeof(int));
+    size_t *bounds = malloc((chunks + 1) * sizeof(size_t));
+    if (!scratch || !bounds) {
+        free(scratch);
+        free(bounds);
+        int_vector_sort(vec);
+        return;
+    }
+    for (size_t i = 0; i <= chunks; i++) {
+        bounds[i] = i * (n / chunks) + (i < n % chunks ? i : n % chunks);
+    }
+
+    // Sort the chunks independently, then merge pairs of runs until one is left
+    struct merge_ctx m = {vec->data, vec->data, bounds, chunks};
+    vector_parallel_for(n, chunks, sort_chunk, &m);
+
+    int *src = vec->data, *dst = scratch;
+    while (m.runs > 1) {
+        m.src = src;
+        m.dst = dst;
+        vector_parallel_for(n, chunks, merge_chunk, &m);
+
+        size_t runs = 0;
+        for (size_t r = 0; r < m.runs; r += 2) {
+            bounds[runs++] = bounds[r];
         }
+        bounds[runs] = n;
+        m.runs = runs;
+        src = dst;
+        dst = src == scratch ? vec->data : scratch;
+    }
+    if (src != vec->data) {
+        memcpy(vec->data, src, n * sizeof(int));
     }
-    
-    return -1;  // Not found
+
+    free(scratch);
+    free(bounds);
+    vec->sorted = true;
 }
 
-bool int_vector_contains(const IntVector *vec, int value) {
+
+// Persistence
+bool int_vector_save(const IntVector *vec, const char *path) {
     assert(vec != NULL);
-    return int_vector_find(vec, value) != -1;
+    assert(path != NULL);
+    return vector_file_save(path, (const int32_t *)vec->data, vec->size,
+                            vec->sorted ? VECTOR_FILE_SORTED : 0);
+}
+
+IntVector *int_vector_load(const char *path) {
+    assert(path != NULL);
+    VectorFileInfo info;
+    int32_t *data;
+    const VectorAllocator *file = vector_file_map(path, VECTOR_MAP_READ_ONLY | VECTOR_MAP_VERIFY, &info, &data);
+    if (!file) return NULL;
+
+    IntVector *vec = int_vector_create(info.count);
+    if (vec) {
+        int_vector_append(vec, data, info.count);
+        vec->sorted = (info.flags & VECTOR_FILE_SORTED) != 0;
+    }
+    vector_mem_free(file, data, info.count * sizeof(int));  // Unmaps the file
+    return vec;
+}
+
+/*
+ * The vector's data is the mapping itself, and its allocator is the one
+ * that owns the mapping: growing the vector moves the data to the heap,
+ * destroying it unmaps the file.
+ */
+IntVector *int_vector_open_mmap(const char *path, unsigned flags) {
+    assert(path != NULL);
+    VectorFileInfo info;
+    int32_t *data;
+    const VectorAllocator *file = vector_file_map(path, flags, &info, &data);
+    if (!file) return NULL;
+
+    IntVector *vec = vector_mem_alloc(file, sizeof(IntVector));
+    if (!vec) {
+        vector_mem_free(file, data, info.count * sizeof(int));
+        return NULL;
+    }
+    int_vector_init(vec, file);
+    vec->data = (int *)data;
+    vec->size = info.count;
+    vec->capacity = info.count;
+    vec->sorted = (info.flags & VECTOR_FILE_SORTED) != 0;
+#ifdef VECTOR_STATS
+    vector_stats_record_resize_(&vec->stats, 0, info.count * sizeof(int), 0, 0);  // Released on destroy like heap data
+#endif
+    return vec;
 }
 
 
-// Utility Operations
-IntVector *int_vector_copy(const IntVector *vec) {
+// Compression
+CompressedIntVector *int_vector_compress(const IntVector *vec) {
     assert(vec != NULL);
-    
-    IntVector *copy = int_vector_create(vec->capacity);
-    if (!copy) return NULL;
-    
-    // Copy data
-    for (size_t i = 0; i < vec->size; i++) {
-        copy->data[i] = vec->data[i];
-    }
-    
-    copy->size = vec->size;
-    return copy;
-}
-
-void int_vector_extend(IntVector *dest, const IntVector *src) {
-    assert(dest != NULL);
-    assert(src != NULL);
-    
-    // Ensure destination has enough capacity
-    size_t new_size = dest->size + src->size;
-    if (new_size > dest->capacity) {
-        size_t new_cap = dest->capacity;
-        while (new_cap < new_size) {
-            new_cap = new_cap == 0 ? DEFAULT_SIZE : new_cap * GROWTH_FACTOR;
-        }
-        bool success = int_vector_resize(dest, new_cap);
-        assert(success);
-    }
-    
-    // Copy elements
-    for (size_t i = 0; i < src->size; i++) {
-        dest->data[dest->size + i] = src->data[i];
-    }
-    
-    dest->size = new_size;
-}
-
-bool int_vector_equals(const IntVector *a, const IntVector *b) {
-    assert(a != NULL);
-    assert(b != NULL);
-    
-    if (a->size != b->size) return false;
-    
-    for (size_t i = 0; i < a->size; i++) {
-        if (a->data[i] != b->data[i]) return false;
-    }
-    
-    return true;
-}
\ No newline at end of file
+    return compressed_int_vector_create(vec->data, vec->size);
+}
+
+IntVector *int_vector_decompress(const CompressedIntVector *cv) {
+    assert(cv != NULL);
+    size_t size = compressed_int_vector_size(cv);
+    IntVector *vec = int_vector_create(size);
+    if (!vec) return NULL;
+    compressed_int_vector_decode(cv, vec->data);
+    vec->size = size;
+    vec->sorted = compressed_int_vector_is_sorted(cv);
+    return vec;
+}
@@ -0,0 +1,209 @@
+#define _POSIX_C_SOURCE 200809L
+#include "vector_io.h"
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FILE_MAGIC "IVEC"
+#define BYTE_ORDER_MARK 0x01020304u
+#define WRITE_CHUNK (1u << 20)   // Elements per fwrite while saving
+
+struct file_header {
+    char magic[4];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t element_size;
+    uint32_t flags;
+    uint32_t header_size;
+    uint64_t count;
+    uint64_t checksum;
+    unsigned char reserved[24];
+};
+
+typedef char file_header_is_64_bytes[sizeof(struct file_header) == VECTOR_FILE_HEADER_SIZE ? 1 : -1];
+
+/* The allocator handed out with a mapping, see vector_io.h */
+struct mapping {
+    VectorAllocator allocator;
+    unsigned char *base;        // Start of the mapping (the header), NULL once unmapped
+    size_t length;
+    size_t live;                // Blocks not yet freed, the mapping included
+};
+
+
+// Helper functions
+static void mapping_release(struct mapping *map) {
+    if (--map->live == 0) free(map);
+}
+
+static bool is_mapped(const struct mapping *map, const void *ptr) {
+    return map->base != NULL && ptr == map->base + VECTOR_FILE_HEADER_SIZE;
+}
+
+static void unmap(struct mapping *map) {
+    munmap(map->base, map->length);
+    map->base = NULL;
+}
+
+static void *mapping_alloc(void *ctx, size_t size) {
+    struct mapping *map = ctx;
+    void *ptr = malloc(size);
+    if (ptr) map->live++;
+    return ptr;
+}
+
+static void *mapping_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+    struct mapping *map = ctx;
+    if (!is_mapped(map, ptr)) return realloc(ptr, new_size);
+
+    // The data leaves the file: copy it to the heap (it stays one live block)
+    void *moved = malloc(new_size);
+    if (!moved) return NULL;
+    memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+    unmap(map);
+    return moved;
+}
+
+static void mapping_free(void *ctx, void *ptr, size_t size) {
+    struct mapping *map = ctx;
+    (void)size;
+    if (is_mapped(map, ptr)) {
+        unmap(map);
+    } else {
+        free(ptr);
+    }
+    mapping_release(map);
+}
+
+static bool read_header(int fd, struct file_header *header, size_t *count) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) return false;
+
+    ssize_t got = pread(fd, header, sizeof(*header), 0);
+    if (got < 0) return false;
+    if ((size_t)got != sizeof(*header) ||
+        memcmp(header->magic, FILE_MAGIC, 4) != 0 ||
+        header->version != VECTOR_FILE_VERSION ||
+        header->byte_order != BYTE_ORDER_MARK ||
+        header->element_size != sizeof(int32_t) ||
+        header->header_size != VECTOR_FILE_HEADER_SIZE ||
+        header->count > (SIZE_MAX - VECTOR_FILE_HEADER_SIZE) / sizeof(int32_t) ||
+        (uint64_t)st.st_size != VECTOR_FILE_HEADER_SIZE + header->count * sizeof(int32_t)) {
+        errno = EINVAL;
+        return false;
+    }
+    *count = (size_t)header->count;
+    return true;
+}
+
+
+// Public API
+uint64_t vector_file_checksum(const int32_t *data, size_t count) {
+    // Fletcher-style: a sums the words, b sums the running a (catches reordering)
+    uint64_t a = count, b = 0;
+    for (size_t i = 0; i < count; i++) {
+        a += (uint32_t)data[i];
+        b += a;
+    }
+    return a ^ (b << 32 | b >> 32);
+}
+
+bool vector_file_save(const char *path, const int32_t *data, size_t count, uint32_t flags) {
+    assert(path != NULL);
+    assert(data != NULL || count == 0);
+
+    struct file_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FILE_MAGIC, 4);
+    header.version = VECTOR_FILE_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.element_size = sizeof(int32_t);
+    header.flags = flags;
+    header.header_size = VECTOR_FILE_HEADER_SIZE;
+    header.count = count;
+    header.checksum = vector_file_checksum(data, count);
+
+    size_t len = strlen(path);
+    char *tmp = malloc(len + 5);
+    if (!tmp) return false;
+    memcpy(tmp, path, len);
+    memcpy(tmp + len, ".tmp", 5);
+
+    FILE *out = fopen(tmp, "wb");
+    bool ok = out != NULL && fwrite(&header, sizeof(header), 1, out) == 1;
+    for (size_t done = 0; ok && done < count; done += WRITE_CHUNK) {
+        size_t n = count - done < WRITE_CHUNK ? count - done : WRITE_CHUNK;
+        ok = fwrite(data + done, sizeof(int32_t), n, out) == n;
+    }
+    if (out && fclose(out) != 0) ok = false;
+    if (ok) ok = rename(tmp, path) == 0;
+
+    if (!ok) {
+        int saved = errno;
+        remove(tmp);
+        errno = saved;
+    }
+    free(tmp);
+    return ok;
+}
+
+const VectorAllocator *vector_file_map(const char *path, unsigned map_flags,
+                                       VectorFileInfo *info, int32_t **data) {
+    assert(path != NULL && info != NULL && data != NULL);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+
+    struct file_header header;
+    size_t count;
+    if (!read_header(fd, &header, &count)) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return NULL;
+    }
+
+    bool cow = (map_flags & VECTOR_MAP_COPY_ON_WRITE) != 0;
+    size_t length = VECTOR_FILE_HEADER_SIZE + count * sizeof(int32_t);
+    void *base = mmap(NULL, length, cow ? PROT_READ | PROT_WRITE : PROT_READ,
+                      cow ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+    int saved = errno;
+    close(fd);  // The mapping keeps the file open
+    if (base == MAP_FAILED) {
+        errno = saved;
+        return NULL;
+    }
+
+    int32_t *elements = (int32_t *)((unsigned char *)base + VECTOR_FILE_HEADER_SIZE);
+    if ((map_flags & VECTOR_MAP_VERIFY) &&
+        vector_file_checksum(elements, count) != header.checksum) {
+        munmap(base, length);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    struct mapping *map = malloc(sizeof(struct mapping));
+    if (!map) {
+        munmap(base, length);
+        errno = ENOMEM;
+        return NULL;
+    }
+    map->allocator.alloc = mapping_alloc;
+    map->allocator.realloc = mapping_realloc;
+    map->allocator.free = mapping_free;
+    map->allocator.ctx = map;
+    map->base = base;
+    map->length = length;
+    map->live = 1;
+
+    info->count = count;
+    info->flags = header.flags;
+    *data = elements;
+    return &map->allocator;
+}
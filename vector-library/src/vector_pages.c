@@ -0,0 +1,97 @@
+#define _GNU_SOURCE  // mremap, MADV_HUGEPAGE
+#include "vector_alloc.h"
+#include <assert.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static bool huge_pages = true;
+
+
+// Helper functions
+/* Mapping length for a block of size bytes: whole pages (0 on overflow) */
+static size_t mapping_length(size_t size) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    if (size > SIZE_MAX - (page - 1)) return 0;
+    return (size + page - 1) / page * page;
+}
+
+static void advise(void *base, size_t length) {
+#ifdef MADV_HUGEPAGE
+    if (huge_pages) madvise(base, length, MADV_HUGEPAGE);  // Only a hint: errors are ignored
+#else
+    (void)base;
+    (void)length;
+#endif
+}
+
+static void *map(size_t length) {
+    if (length == 0) return NULL;
+    void *base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) return NULL;
+    advise(base, length);
+    return base;
+}
+
+
+// Public API
+void *vector_pages_alloc(size_t size) {
+    assert(size >= VECTOR_PAGE_THRESHOLD);
+    return map(mapping_length(size));
+}
+
+void *vector_pages_realloc(void *ptr, size_t old_size, size_t new_size) {
+    assert(ptr != NULL);
+
+    // Across the threshold the block changes kind: one copy
+    if (old_size < VECTOR_PAGE_THRESHOLD || new_size < VECTOR_PAGE_THRESHOLD) {
+        if (old_size < VECTOR_PAGE_THRESHOLD && new_size < VECTOR_PAGE_THRESHOLD) {
+            return realloc(ptr, new_size);
+        }
+        void *moved = new_size >= VECTOR_PAGE_THRESHOLD ? vector_pages_alloc(new_size) : malloc(new_size);
+        if (!moved) return NULL;
+        memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+        vector_pages_free(ptr, old_size);
+        return moved;
+    }
+
+    size_t old_length = mapping_length(old_size);
+    size_t new_length = mapping_length(new_size);
+    if (new_length == 0) return NULL;
+    if (new_length == old_length) return ptr;
+
+#ifdef MREMAP_MAYMOVE
+    // The kernel grows the mapping in place or moves its page table entries
+    void *base = mremap(ptr, old_length, new_length, MREMAP_MAYMOVE);
+    return base == MAP_FAILED ? NULL : base;
+#else
+    void *base = map(new_length);
+    if (!base) return NULL;
+    memcpy(base, ptr, old_length < new_length ? old_length : new_length);
+    munmap(ptr, old_length);
+    return base;
+#endif
+}
+
+void vector_pages_free(void *ptr, size_t size) {
+    if (!ptr) return;
+    if (size < VECTOR_PAGE_THRESHOLD) {
+        free(ptr);
+    } else {
+        munmap(ptr, mapping_length(size));
+    }
+}
+
+bool vector_pages_remaps(size_t old_size, size_t new_size) {
+#ifdef MREMAP_MAYMOVE
+    return old_size >= VECTOR_PAGE_THRESHOLD && new_size >= VECTOR_PAGE_THRESHOLD;
+#else
+    (void)old_size;
+    (void)new_size;
+    return false;
+#endif
+}
+
+void vector_pages_set_huge(bool enabled) {
+    huge_pages = enabled;
+}
@@ -0,0 +1,197 @@
+#define _POSIX_C_SOURCE 200809L
+#include "vector_parallel.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define CHUNKS_PER_THREAD 4     // Over-split so uneven chunks balance out
+#define MAX_THREADS 256
+
+struct job {
+    VectorChunkFn body;
+    void *ctx;
+    size_t count;
+    size_t chunks;
+    size_t next;                // Next chunk to hand out
+    size_t done;                // Chunks finished
+};
+
+/* pool_lock protects everything below it; run_lock admits one job at a time */
+static pthread_mutex_t run_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_ready = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t work_done = PTHREAD_COND_INITIALIZER;
+static pthread_t *workers = NULL;
+static unsigned worker_count = 0;
+static bool pool_started = false;
+static bool stopping = false;
+static struct job *current = NULL;
+
+static unsigned requested_threads = 0;  // 0: from VECTOR_THREADS or the CPU count
+static size_t grain_size = VECTOR_PARALLEL_GRAIN;
+
+
+// Helper functions
+static void chunk_range(const struct job *job, size_t chunk, size_t *begin, size_t *end) {
+    size_t base = job->count / job->chunks;
+    size_t extra = job->count % job->chunks;  // The first chunks get one more
+    *begin = chunk * base + (chunk < extra ? chunk : extra);
+    *end = *begin + base + (chunk < extra ? 1 : 0);
+}
+
+/* Runs chunks until none are left to hand out; called with pool_lock held */
+static void run_chunks(struct job *job) {
+    while (job->next < job->chunks) {
+        size_t chunk = job->next++;
+        size_t begin, end;
+        chunk_range(job, chunk, &begin, &end);
+
+        pthread_mutex_unlock(&pool_lock);
+        job->body(chunk, begin, end, job->ctx);
+        pthread_mutex_lock(&pool_lock);
+
+        if (++job->done == job->chunks) {
+            pthread_cond_broadcast(&work_done);
+        }
+    }
+}
+
+static void *worker_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&pool_lock);
+    for (;;) {
+        while (!stopping && (current == NULL || current->next == current->chunks)) {
+            pthread_cond_wait(&work_ready, &pool_lock);
+        }
+        if (stopping) break;
+        run_chunks(current);
+    }
+    pthread_mutex_unlock(&pool_lock);
+    return NULL;
+}
+
+static unsigned default_threads(void) {
+    const char *env = getenv("VECTOR_THREADS");
+    if (env != NULL) {
+        long n = strtol(env, NULL, 10);
+        if (n > 0) return n < MAX_THREADS ? (unsigned)n : MAX_THREADS;
+    }
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) return 1;
+    return cpus < MAX_THREADS ? (unsigned)cpus : MAX_THREADS;
+}
+
+/* Starts the workers if needed; called with pool_lock held */
+static void start_pool(void) {
+    static bool exit_hook = false;
+    unsigned threads = requested_threads > 0 ? requested_threads : default_threads();
+
+    pool_started = true;
+    worker_count = 0;
+    if (threads <= 1) return;
+
+    workers = malloc((threads - 1) * sizeof(pthread_t));
+    if (!workers) return;  // Everything runs on the caller
+    for (unsigned i = 0; i < threads - 1; i++) {
+        if (pthread_create(&workers[i], NULL, worker_main, NULL) != 0) break;
+        worker_count++;
+    }
+
+    if (!exit_hook) {
+        atexit(vector_parallel_shutdown);
+        exit_hook = true;
+    }
+}
+
+
+// Running work
+size_t vector_parallel_chunks(size_t count) {
+    size_t grain = vector_parallel_grain();
+    size_t threads = vector_parallel_threads();
+    if (threads <= 1 || count / 2 < grain) return 1;
+
+    size_t chunks = count / grain;
+    size_t most = threads * CHUNKS_PER_THREAD;
+    return chunks < most ? chunks : most;
+}
+
+void vector_parallel_for(size_t count, size_t chunks, VectorChunkFn body, void *ctx) {
+    assert(body != NULL);
+    assert(chunks > 0);
+    struct job job = {body, ctx, count, chunks, 0, 0};
+
+    // One chunk, or the pool is busy (possibly with our own caller): run here
+    if (chunks == 1 || pthread_mutex_trylock(&run_lock) != 0) {
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            size_t begin, end;
+            chunk_range(&job, chunk, &begin, &end);
+            body(chunk, begin, end, ctx);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&pool_lock);
+    if (!pool_started) start_pool();
+    current = &job;
+    pthread_cond_broadcast(&work_ready);
+    run_chunks(&job);
+    while (job.done < job.chunks) {
+        pthread_cond_wait(&work_done, &pool_lock);
+    }
+    current = NULL;
+    pthread_mutex_unlock(&pool_lock);
+    pthread_mutex_unlock(&run_lock);
+}
+
+
+// Configuration
+void vector_parallel_set_threads(unsigned threads) {
+    vector_parallel_shutdown();
+    pthread_mutex_lock(&pool_lock);
+    requested_threads = threads < MAX_THREADS ? threads : MAX_THREADS;
+    pthread_mutex_unlock(&pool_lock);
+}
+
+unsigned vector_parallel_threads(void) {
+    pthread_mutex_lock(&pool_lock);
+    if (!pool_started) start_pool();
+    unsigned threads = worker_count + 1;
+    pthread_mutex_unlock(&pool_lock);
+    return threads;
+}
+
+void vector_parallel_set_grain(size_t grain) {
+    pthread_mutex_lock(&pool_lock);
+    grain_size = grain > 0 ? grain : VECTOR_PARALLEL_GRAIN;
+    pthread_mutex_unlock(&pool_lock);
+}
+
+size_t vector_parallel_grain(void) {
+    pthread_mutex_lock(&pool_lock);
+    size_t grain = grain_size;
+    pthread_mutex_unlock(&pool_lock);
+    return grain;
+}
+
+void vector_parallel_shutdown(void) {
+    pthread_mutex_lock(&run_lock);  // Let a running job finish
+    pthread_mutex_lock(&pool_lock);
+    stopping = true;
+    pthread_cond_broadcast(&work_ready);
+    pthread_mutex_unlock(&pool_lock);
+
+    for (unsigned i = 0; i < worker_count; i++) {
+        pthread_join(workers[i], NULL);
+    }
+
+    pthread_mutex_lock(&pool_lock);
+    free(workers);
+    workers = NULL;
+    worker_count = 0;
+    pool_started = false;
+    stopping = false;
+    pthread_mutex_unlock(&pool_lock);
+    pthread_mutex_unlock(&run_lock);
+}
@@ -0,0 +1,371 @@
+#include "vector_simd.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAVE_X86_KERNELS 1
+#endif
+
+/*
+ * Each kernel set works on whole SIMD registers and leaves the last
+ * count % width elements to the scalar loops. Elements are read through
+ * memcpy in the scalar code, so data may hold any 4-byte type.
+ */
+struct simd_kernels {
+    const char *name;
+    size_t (*find32)(const void *data, size_t count, uint32_t value);
+    size_t (*count32)(const void *data, size_t count, uint32_t value);
+    int64_t (*sum_i32)(const int32_t *data, size_t count);
+    int32_t (*min_i32)(const int32_t *data, size_t count);
+    int32_t (*max_i32)(const int32_t *data, size_t count);
+};
+
+
+// Scalar kernels (also used for the tails of the SIMD ones)
+static uint32_t load32(const void *data, size_t index) {
+    uint32_t v;
+    memcpy(&v, (const unsigned char *)data + index * 4, 4);
+    return v;
+}
+
+static size_t find32_scalar(const void *data, size_t count, uint32_t value) {
+    for (size_t i = 0; i < count; i++) {
+        if (load32(data, i) == value) return i;
+    }
+    return count;
+}
+
+static size_t count32_scalar(const void *data, size_t count, uint32_t value) {
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        n += load32(data, i) == value;
+    }
+    return n;
+}
+
+static int64_t sum_i32_scalar(const int32_t *data, size_t count) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < count; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+static int32_t min_i32_scalar(const int32_t *data, size_t count) {
+    int32_t min = data[0];
+    for (size_t i = 1; i < count; i++) {
+        if (data[i] < min) min = data[i];
+    }
+    return min;
+}
+
+static int32_t max_i32_scalar(const int32_t *data, size_t count) {
+    int32_t max = data[0];
+    for (size_t i = 1; i < count; i++) {
+        if (data[i] > max) max = data[i];
+    }
+    return max;
+}
+
+
+#ifdef HAVE_X86_KERNELS
+// SSE2 kernels: 4 elements per register, 16 per loop iteration for search
+__attribute__((target("sse2")))
+static size_t find32_sse2(const void *data, size_t count, uint32_t value) {
+    const unsigned char *p = data;
+    const __m128i key = _mm_set1_epi32((int)value);
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(p + i * 4)), key);
+        __m128i b = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(p + i * 4 + 16)), key);
+        __m128i c = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(p + i * 4 + 32)), key);
+        __m128i d = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(p + i * 4 + 48)), key);
+        unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(a)) |
+                        (unsigned)_mm_movemask_ps(_mm_castsi128_ps(b)) << 4 |
+                        (unsigned)_mm_movemask_ps(_mm_castsi128_ps(c)) << 8 |
+                        (unsigned)_mm_movemask_ps(_mm_castsi128_ps(d)) << 12;
+        if (mask != 0) return i + (size_t)__builtin_ctz(mask);
+    }
+    for (; i + 4 <= count; i += 4) {
+        __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(p + i * 4)), key);
+        unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(eq));
+        if (mask != 0) return i + (size_t)__builtin_ctz(mask);
+    }
+
+    return i + find32_scalar(p + i * 4, count - i, value);
+}
+
+__attribute__((target("sse2")))
+static size_t count32_sse2(const void *data, size_t count, uint32_t value) {
+    const unsigned char *p = data;
+    const __m128i key = _mm_set1_epi32((int)value);
+    size_t n = 0, i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(p + i * 4)), key);
+        n += (size_t)__builtin_popcount((unsigned)_mm_movemask_ps(_mm_castsi128_ps(eq)));
+    }
+
+    return n + count32_scalar(p + i * 4, count - i, value);
+}
+
+__attribute__((target("sse2")))
+static int64_t sum_i32_sse2(const int32_t *data, size_t count) {
+    __m128i acc = _mm_setzero_si128();  // Two 64-bit lanes
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i sign = _mm_srai_epi32(v, 31);  // Sign-extend to 64 bits
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+    }
+
+    int64_t lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, acc);
+    return lanes[0] + lanes[1] + sum_i32_scalar(data + i, count - i);
+}
+
+// SSE2 has no signed 32-bit min/max (that is SSE4.1): select with a compare
+__attribute__((target("sse2")))
+static __m128i select_i32(__m128i mask, __m128i if_set, __m128i if_clear) {
+    return _mm_or_si128(_mm_and_si128(mask, if_set), _mm_andnot_si128(mask, if_clear));
+}
+
+__attribute__((target("sse2")))
+static int32_t min_i32_sse2(const int32_t *data, size_t count) {
+    if (count < 4) return min_i32_scalar(data, count);
+
+    __m128i best = _mm_loadu_si128((const __m128i *)data);
+    size_t i = 4;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+        best = select_i32(_mm_cmplt_epi32(v, best), v, best);
+    }
+
+    int32_t lanes[4];
+    _mm_storeu_si128((__m128i *)lanes, best);
+    int32_t min = min_i32_scalar(lanes, 4);
+    if (i < count) {
+        int32_t tail = min_i32_scalar(data + i, count - i);
+        if (tail < min) min = tail;
+    }
+    return min;
+}
+
+__attribute__((target("sse2")))
+static int32_t max_i32_sse2(const int32_t *data, size_t count) {
+    if (count < 4) return max_i32_scalar(data, count);
+
+    __m128i best = _mm_loadu_si128((const __m128i *)data);
+    size_t i = 4;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+        best = select_i32(_mm_cmpgt_epi32(v, best), v, best);
+    }
+
+    int32_t lanes[4];
+    _mm_storeu_si128((__m128i *)lanes, best);
+    int32_t max = max_i32_scalar(lanes, 4);
+    if (i < count) {
+        int32_t tail = max_i32_scalar(data + i, count - i);
+        if (tail > max) max = tail;
+    }
+    return max;
+}
+
+
+// AVX2 kernels: 8 elements per register, 32 per loop iteration for search
+__attribute__((target("avx2,popcnt,bmi")))
+static size_t find32_avx2(const void *data, size_t count, uint32_t value) {
+    const unsigned char *p = data;
+    const __m256i key = _mm256_set1_epi32((int)value);
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(p + i * 4)), key);
+        __m256i b = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(p + i * 4 + 32)), key);
+        __m256i c = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(p + i * 4 + 64)), key);
+        __m256i d = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(p + i * 4 + 96)), key);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+        if (!_mm256_testz_si256(any, any)) {
+            // Rare: locate the match within the 32 elements
+            uint32_t mask = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(a)) |
+                            (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(b)) << 8 |
+                            (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(c)) << 16 |
+                            (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(d)) << 24;
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+    for (; i + 8 <= count; i += 8) {
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(p + i * 4)), key);
+        unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(eq));
+        if (mask != 0) return i + (size_t)__builtin_ctz(mask);
+    }
+
+    return i + find32_scalar(p + i * 4, count - i, value);
+}
+
+__attribute__((target("avx2,popcnt,bmi")))
+static size_t count32_avx2(const void *data, size_t count, uint32_t value) {
+    const unsigned char *p = data;
+    const __m256i key = _mm256_set1_epi32((int)value);
+    size_t n = 0, i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(p + i * 4)), key);
+        n += (size_t)__builtin_popcount((unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+    }
+
+    return n + count32_scalar(p + i * 4, count - i, value);
+}
+
+__attribute__((target("avx2,popcnt,bmi")))
+static int64_t sum_i32_avx2(const int32_t *data, size_t count) {
+    __m256i acc = _mm256_setzero_si256();  // Four 64-bit lanes
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m128i lo = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i hi = _mm_loadu_si128((const __m128i *)(data + i + 4));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(lo));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(hi));
+    }
+
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sum_i32_scalar(data + i, count - i);
+}
+
+__attribute__((target("avx2,popcnt,bmi")))
+static int32_t min_i32_avx2(const int32_t *data, size_t count) {
+    if (count < 8) return min_i32_scalar(data, count);
+
+    __m256i best = _mm256_loadu_si256((const __m256i *)data);
+    size_t i = 8;
+    for (; i + 8 <= count; i += 8) {
+        best = _mm256_min_epi32(best, _mm256_loadu_si256((const __m256i *)(data + i)));
+    }
+
+    int32_t lanes[8];
+    _mm256_storeu_si256((__m256i *)lanes, best);
+    int32_t min = min_i32_scalar(lanes, 8);
+    if (i < count) {
+        int32_t tail = min_i32_scalar(data + i, count - i);
+        if (tail < min) min = tail;
+    }
+    return min;
+}
+
+__attribute__((target("avx2,popcnt,bmi")))
+static int32_t max_i32_avx2(const int32_t *data, size_t count) {
+    if (count < 8) return max_i32_scalar(data, count);
+
+    __m256i best = _mm256_loadu_si256((const __m256i *)data);
+    size_t i = 8;
+    for (; i + 8 <= count; i += 8) {
+        best = _mm256_max_epi32(best, _mm256_loadu_si256((const __m256i *)(data + i)));
+    }
+
+    int32_t lanes[8];
+    _mm256_storeu_si256((__m256i *)lanes, best);
+    int32_t max = max_i32_scalar(lanes, 8);
+    if (i < count) {
+        int32_t tail = max_i32_scalar(data + i, count - i);
+        if (tail > max) max = tail;
+    }
+    return max;
+}
+#endif /* HAVE_X86_KERNELS */
+
+static const struct simd_kernels kernels[] = {
+    {"scalar", find32_scalar, count32_scalar, sum_i32_scalar, min_i32_scalar, max_i32_scalar},
+#ifdef HAVE_X86_KERNELS
+    {"sse2", find32_sse2, count32_sse2, sum_i32_sse2, min_i32_sse2, max_i32_sse2},
+    {"avx2", find32_avx2, count32_avx2, sum_i32_avx2, min_i32_avx2, max_i32_avx2},
+#endif
+};
+
+static const struct simd_kernels *active = NULL;
+
+/*
+ * Pick a kernel set: the best this CPU supports (__builtin_cpu_supports
+ * also checks that the OS saves the AVX registers), or the named one if it
+ * is not better than that.
+ */
+const char *vector_simd_select(const char *name) {
+    size_t best = 0;
+
+#ifdef HAVE_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        best = 2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        best = 1;
+    }
+#endif
+
+    size_t chosen = best;
+    if (name != NULL) {
+        for (size_t k = 0; k <= best; k++) {
+            if (strcmp(name, kernels[k].name) == 0) {
+                chosen = k;
+                break;
+            }
+        }
+    }
+
+    active = &kernels[chosen];
+    return active->name;
+}
+
+static const struct simd_kernels *in_use(void) {
+    if (active == NULL) vector_simd_select(getenv("VECTOR_SIMD"));
+    return active;
+}
+
+const char *vector_simd_name(void) {
+    return in_use()->name;
+}
+
+#ifdef __GNUC__
+/* Choose before main() runs, so threads never race on the first use */
+__attribute__((constructor))
+static void vector_simd_init(void) {
+    in_use();
+}
+#endif
+
+
+// Public entry points
+size_t vector_simd_find32(const void *data, size_t count, uint32_t value) {
+    assert(data != NULL || count == 0);
+    if (count == 0) return 0;
+    return in_use()->find32(data, count, value);
+}
+
+size_t vector_simd_count32(const void *data, size_t count, uint32_t value) {
+    assert(data != NULL || count == 0);
+    if (count == 0) return 0;
+    return in_use()->count32(data, count, value);
+}
+
+int64_t vector_simd_sum_i32(const int32_t *data, size_t count) {
+    assert(data != NULL || count == 0);
+    if (count == 0) return 0;
+    return in_use()->sum_i32(data, count);
+}
+
+int32_t vector_simd_min_i32(const int32_t *data, size_t count) {
+    assert(data != NULL && count > 0);
+    return in_use()->min_i32(data, count);
+}
+
+int32_t vector_simd_max_i32(const int32_t *data, size_t count) {
+    assert(data != NULL && count > 0);
+    return in_use()->max_i32(data, count);
+}
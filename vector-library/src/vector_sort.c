@@ -0,0 +1,71 @@
+#include "vector_sort.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES (32 / RADIX_BITS)
+
+
+/*
+ * Sorts keys by (key ^ flip): flipping the sign bit maps int32_t order
+ * onto uint32_t order, so both entry points share one loop. The digit
+ * histograms of all passes are built in a single read of the input.
+ */
+static bool radix_sort32(uint32_t *data, size_t count, uint32_t flip) {
+    size_t hist[RADIX_PASSES][RADIX_BUCKETS];
+
+    if (count < 2) return true;
+
+    memset(hist, 0, sizeof(hist));
+    for (size_t i = 0; i < count; i++) {
+        uint32_t key = data[i] ^ flip;
+        for (int pass = 0; pass < RADIX_PASSES; pass++) {
+            hist[pass][(key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+
+    uint32_t *scratch = malloc(count * sizeof(uint32_t));
+    if (!scratch) return false;
+
+    uint32_t *src = data;
+    uint32_t *dst = scratch;
+    for (int pass = 0; pass < RADIX_PASSES; pass++) {
+        unsigned shift = (unsigned)pass * RADIX_BITS;
+        size_t *counts = hist[pass];
+
+        // Every key has the same digit: this pass would not move anything
+        if (counts[((src[0] ^ flip) >> shift) & (RADIX_BUCKETS - 1)] == count) continue;
+
+        size_t offset = 0;
+        for (int d = 0; d < RADIX_BUCKETS; d++) {
+            size_t n = counts[d];
+            counts[d] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < count; i++) {
+            uint32_t key = src[i];
+            dst[counts[((key ^ flip) >> shift) & (RADIX_BUCKETS - 1)]++] = key;
+        }
+
+        uint32_t *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != data) {
+        memcpy(data, src, count * sizeof(uint32_t));
+    }
+    free(scratch);
+    return true;
+}
+
+
+// Public API
+bool vector_radix_sort_i32(int32_t *data, size_t count) {
+    return radix_sort32((uint32_t *)data, count, UINT32_C(0x80000000));
+}
+
+bool vector_radix_sort_u32(uint32_t *data, size_t count) {
+    return radix_sort32(data, count, 0);
+}
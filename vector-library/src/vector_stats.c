@@ -0,0 +1,99 @@
+#include "vector_stats.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+
+static VectorStats global;
+
+#ifndef __GNUC__
+#error "vector_stats.c needs the GCC/Clang __atomic builtins"
+#endif
+
+/* Vectors live in many threads: the totals are updated atomically */
+#define ADD(field, n) __atomic_fetch_add(&global.field, (uint64_t)(n), __ATOMIC_RELAXED)  // Returns the old value
+#define SUB(field, n) __atomic_fetch_sub(&global.field, (uint64_t)(n), __ATOMIC_RELAXED)
+#define LOAD(field) __atomic_load_n(&global.field, __ATOMIC_RELAXED)
+
+
+// Helper functions
+static void raise_global_peak(uint64_t bytes) {
+    uint64_t peak = LOAD(peak_bytes);
+    while (bytes > peak &&
+           !__atomic_compare_exchange_n(&global.peak_bytes, &peak, bytes, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+
+// Recording (called from the vector implementation)
+void vector_stats_record_resize_(VectorStats *stats, size_t old_bytes, size_t new_bytes,
+                                 size_t allocated, size_t copied) {
+    assert(stats != NULL);
+    stats->resizes++;
+    stats->bytes_allocated += allocated;
+    stats->bytes_copied += copied;
+    stats->capacity_bytes = new_bytes;
+    if (new_bytes > stats->peak_bytes) stats->peak_bytes = new_bytes;
+
+    ADD(resizes, 1);
+    ADD(bytes_allocated, allocated);
+    ADD(bytes_copied, copied);
+    if (new_bytes >= old_bytes) {
+        raise_global_peak(ADD(capacity_bytes, new_bytes - old_bytes) + (new_bytes - old_bytes));
+    } else {
+        SUB(capacity_bytes, old_bytes - new_bytes);
+    }
+}
+
+void vector_stats_record_shift_(VectorStats *stats, size_t bytes) {
+    assert(stats != NULL);
+    stats->bytes_shifted += bytes;
+    ADD(bytes_shifted, bytes);
+}
+
+void vector_stats_record_release_(VectorStats *stats, size_t capacity_bytes, size_t size_bytes) {
+    assert(stats != NULL);
+    assert(size_bytes <= capacity_bytes);
+    stats->capacity_bytes = 0;
+    SUB(capacity_bytes, capacity_bytes);
+    ADD(wasted_bytes, capacity_bytes - size_bytes);
+}
+
+
+// Public API
+void vector_stats_global(VectorStats *out) {
+    assert(out != NULL);
+    out->resizes = LOAD(resizes);
+    out->bytes_allocated = LOAD(bytes_allocated);
+    out->bytes_copied = LOAD(bytes_copied);
+    out->bytes_shifted = LOAD(bytes_shifted);
+    out->capacity_bytes = LOAD(capacity_bytes);
+    out->peak_bytes = LOAD(peak_bytes);
+    out->wasted_bytes = LOAD(wasted_bytes);
+}
+
+void vector_stats_reset(void) {
+    uint64_t live = LOAD(capacity_bytes);
+    VectorStats zero;
+    memset(&zero, 0, sizeof(zero));
+    zero.capacity_bytes = live;
+    zero.peak_bytes = live;
+    global = zero;
+}
+
+void vector_stats_dump(FILE *out, const char *label, const VectorStats *stats) {
+    assert(out != NULL);
+    VectorStats totals;
+    if (!stats) {
+        vector_stats_global(&totals);
+        stats = &totals;
+    }
+    fprintf(out, "%s:\n", label ? label : "vector stats");
+    fprintf(out, "  resizes          %llu\n", (unsigned long long)stats->resizes);
+    fprintf(out, "  bytes allocated  %llu\n", (unsigned long long)stats->bytes_allocated);
+    fprintf(out, "  bytes copied     %llu\n", (unsigned long long)stats->bytes_copied);
+    fprintf(out, "  bytes shifted    %llu\n", (unsigned long long)stats->bytes_shifted);
+    fprintf(out, "  capacity bytes   %llu\n", (unsigned long long)stats->capacity_bytes);
+    fprintf(out, "  peak bytes       %llu\n", (unsigned long long)stats->peak_bytes);
+    fprintf(out, "  wasted bytes     %llu\n", (unsigned long long)stats->wasted_bytes);
+}
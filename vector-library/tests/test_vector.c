@@ -1,4 +1,13 @@
 #include "../include/vector_int.h"
+#include "../include/vector_generic.h"
+#include "../include/vector_concurrent.h"
+#include "../include/vector_deque.h"
+#include "../include/vector_parallel.h"
+#include "../include/vector_simd.h"
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <string.h>
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -13,6 +22,25 @@ static int tests_passed = 0;
     tests_passed++; \
 } while(0)
 
+// Generated vectors for element types other than int
+struct point {
+    int x;
+    int y;
+};
+
+VECTOR_DEFINE_INLINE_ORDERED(DoubleVector, double_vector, double);
+VECTOR_DEFINE_INLINE(PointVector, point_vector, struct point);
+
+static int compare_ints(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
 // ==================== Test Cases ====================
 
 static void test_create_destroy() {
@@ -237,9 +265,993 @@ static void test_edge_cases() {
     int_vector_destroy(vec);
 }
 
+static bool is_odd(int value, void *ctx) {
+    (void)ctx;
+    return value % 2 != 0;
+}
+
+static bool above(int value, void *ctx) {
+    return value > *(int*)ctx;
+}
+
+static void test_bulk_operations() {
+    IntVector* vec = int_vector_create(2);
+    int values[] = {1, 2, 3, 4, 5};
+
+    // push_n and append: one growth for the whole batch
+    int_vector_push_n(vec, 7, 3);
+    int_vector_append(vec, values, 5);
+    assert(int_vector_size(vec) == 8);
+    assert(int_vector_capacity(vec) == 8);
+    assert(int_vector_get(vec, 2) == 7);
+    assert(int_vector_get(vec, 3) == 1);
+    assert(int_vector_get(vec, 7) == 5);
+
+    // insert_range in the middle, at the front and at the end: [7 7 1 2 3 4 5] -> ...
+    int_vector_insert_range(vec, 3, values, 2);     // 7 7 7 1 2 1 2 3 4 5
+    assert(int_vector_size(vec) == 10);
+    assert(int_vector_get(vec, 3) == 1 && int_vector_get(vec, 4) == 2 && int_vector_get(vec, 5) == 1);
+    int_vector_insert_range(vec, 0, values + 4, 1); // 5 7 7 7 1 2 1 2 3 4 5
+    int_vector_insert_range(vec, int_vector_size(vec), values, 1);
+    assert(int_vector_get(vec, 0) == 5);
+    assert(int_vector_get(vec, 11) == 1);
+    int_vector_insert_range(vec, 4, NULL, 0);
+    assert(int_vector_size(vec) == 12);
+
+    // remove_range
+    int_vector_remove_range(vec, 0, 4);             // 1 2 1 2 3 4 5 1
+    assert(int_vector_size(vec) == 8);
+    assert(int_vector_get(vec, 0) == 1 && int_vector_get(vec, 4) == 3);
+    int_vector_remove_range(vec, 6, 2);             // 1 2 1 2 3 4
+    int_vector_remove_range(vec, 3, 0);
+    assert(int_vector_size(vec) == 6 && int_vector_get(vec, 5) == 4);
+
+    // erase_if keeps the order of the survivors
+    assert(int_vector_erase_if(vec, is_odd, NULL) == 3);  // 2 2 4
+    assert(int_vector_size(vec) == 3);
+    assert(int_vector_get(vec, 0) == 2 && int_vector_get(vec, 2) == 4);
+    int limit = 2;
+    assert(int_vector_erase_if(vec, above, &limit) == 1);
+    assert(int_vector_size(vec) == 2);
+
+    int_vector_destroy(vec);
+}
+
+static void test_bulk_self_insert() {
+    // A generated vector exposes its storage, so a range can come from inside it
+    DoubleVector* vec = double_vector_create(4);
+    double expected[] = {0, 1, 1, 2, 3, 2, 3, 0, 1};
+    for (int i = 0; i < 4; i++) {
+        double_vector_push(vec, i);
+    }
+
+    // vec[1..4) inserted at 2: the shift splits the source, and the block grows
+    double_vector_insert_range(vec, 2, vec->data + 1, 3);   // 0 1 1 2 3 2 3
+    assert(double_vector_size(vec) == 7);
+    double_vector_append(vec, vec->data, 2);                 // ... 0 1
+    assert(double_vector_size(vec) == 9);
+    for (int i = 0; i < 9; i++) {
+        assert(double_vector_get(vec, i) == expected[i]);
+    }
+
+    double_vector_destroy(vec);
+}
+
+static void test_reductions() {
+    IntVector* vec = int_vector_create(8);
+    int values[] = {5, -3, 7, -3, 7, 2};
+    int_vector_append(vec, values, 6);
+
+    assert(int_vector_sum(vec) == 15);
+    assert(int_vector_min(vec) == -3);
+    assert(int_vector_max(vec) == 7);
+    assert(int_vector_min_index(vec) == 1);  // First of the ties
+    assert(int_vector_max_index(vec) == 2);
+    assert(int_vector_count_equal(vec, 7) == 2);
+    assert(int_vector_count_equal(vec, 99) == 0);
+
+    // The sum is 64-bit: no int overflow
+    int_vector_clear(vec);
+    int_vector_push_n(vec, INT_MAX, 100);
+    int_vector_push(vec, INT_MIN);
+    assert(int_vector_sum(vec) == 100LL * INT_MAX + INT_MIN);
+    assert(int_vector_min_index(vec) == 100);
+
+    IntVector* empty = int_vector_create(0);
+    assert(int_vector_sum(empty) == 0);
+    assert(int_vector_count_equal(empty, 0) == 0);
+
+    int_vector_destroy(vec);
+    int_vector_destroy(empty);
+}
+
+static void test_simd_kernels_agree() {
+    const char *kernels[] = {"scalar", "sse2", "avx2"};
+    int data[300];
+    unsigned seed = 12345;
+
+    for (size_t i = 0; i < 300; i++) {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = (int)((seed >> 16) % 64) - 32;
+    }
+
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        vector_simd_select(kernels[k]);  // Falls back to the best supported kernel
+
+        // Every length around the SIMD widths, every value in range
+        for (size_t len = 1; len <= 300; len += (len < 80 ? 1 : 37)) {
+            IntVector* vec = int_vector_create(len);
+            int_vector_append(vec, data, len);
+
+            long long sum = 0;
+            int min = data[0], max = data[0];
+            for (size_t i = 0; i < len; i++) {
+                sum += data[i];
+                if (data[i] < min) min = data[i];
+                if (data[i] > max) max = data[i];
+            }
+            assert(int_vector_sum(vec) == sum);
+            assert(int_vector_min(vec) == min);
+            assert(int_vector_max(vec) == max);
+
+            for (int value = -33; value <= 32; value++) {
+                int first = -1;
+                size_t count = 0;
+                for (size_t i = 0; i < len; i++) {
+                    if (data[i] == value) {
+                        if (first == -1) first = (int)i;
+                        count++;
+                    }
+                }
+                assert(int_vector_find(vec, value) == first);
+                assert(int_vector_contains(vec, value) == (first != -1));
+                assert(int_vector_count_equal(vec, value) == count);
+            }
+
+            int_vector_destroy(vec);
+        }
+    }
+
+    vector_simd_select(NULL);
+}
+
+static void test_generic_types() {
+    // double: same API and semantics as IntVector
+    DoubleVector* d = double_vector_create(0);
+    assert(double_vector_capacity(d) == 8);
+    for (int i = 0; i < 20; i++) {
+        double_vector_push(d, i * 0.5);
+    }
+    double_vector_insert(d, 0, -1.5);
+    double_vector_remove(d, 1);
+    assert(double_vector_size(d) == 20);
+    assert(double_vector_get(d, 0) == -1.5);
+    assert(double_vector_get(d, 19) == 9.5);
+    assert(double_vector_find(d, 2.5) == 5);
+    assert(!double_vector_contains(d, 0.25));
+
+    DoubleVector* dc = double_vector_copy(d);
+    assert(double_vector_equals(d, dc));
+    double_vector_extend(dc, dc);  // Extending with itself doubles the contents
+    assert(double_vector_size(dc) == 40);
+    assert(double_vector_get(dc, 20) == -1.5);
+    assert(double_vector_pop(dc) == 9.5);
+
+    // Structs are stored by value and compared bytewise
+    PointVector* p = point_vector_create(2);
+    struct point a = {1, 2}, b = {3, 4}, c = {1, 3};
+    point_vector_push(p, a);
+    point_vector_push(p, b);
+    point_vector_push(p, a);
+    assert(point_vector_size(p) == 3);
+    assert(point_vector_get(p, 1).x == 3);
+    assert(point_vector_find(p, a) == 0);
+    assert(point_vector_find(p, c) == -1);
+    point_vector_set(p, 0, c);
+    assert(point_vector_find(p, a) == 2);
+    point_vector_shrink_to_fit(p);
+    assert(point_vector_capacity(p) == 3);
+
+    double_vector_destroy(d);
+    double_vector_destroy(dc);
+    point_vector_destroy(p);
+}
+
+// Allocator that counts calls and live bytes, backed by malloc
+struct alloc_stats {
+    int allocs, reallocs, frees;
+    size_t live;
+};
+
+static void *counting_alloc(void *ctx, size_t size) {
+    struct alloc_stats *stats = ctx;
+    stats->allocs++;
+    stats->live += size;
+    return malloc(size);
+}
+
+static void *counting_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+    struct alloc_stats *stats = ctx;
+    stats->reallocs++;
+    stats->live += new_size - old_size;  // Wraps back correctly when shrinking
+    return realloc(ptr, new_size);
+}
+
+static void counting_free(void *ctx, void *ptr, size_t size) {
+    struct alloc_stats *stats = ctx;
+    stats->frees++;
+    stats->live -= size;
+    free(ptr);
+}
+
+static void test_allocator() {
+    struct alloc_stats stats = {0, 0, 0, 0};
+    VectorAllocator allocator = {counting_alloc, counting_realloc, counting_free, &stats};
+
+    IntVector* vec = int_vector_create_with(2, &allocator);
+    assert(stats.allocs == 1);  // Just the struct: the data is inline
+    for (int i = 0; i < 100; i++) {
+        int_vector_push(vec, i);
+    }
+    assert(stats.reallocs > 0);
+    assert(int_vector_get(vec, 99) == 99);
+
+    // A copy draws from the same allocator
+    IntVector* copy = int_vector_copy(vec);
+    assert(int_vector_equals(vec, copy));
+    assert(stats.allocs == 4);
+
+    int_vector_shrink_to_fit(vec);
+    int_vector_destroy(vec);
+    int_vector_destroy(copy);
+    assert(stats.frees == 4);
+    assert(stats.live == 0);  // Sizes passed back match what was handed out
+}
+
+static void test_arena() {
+    VectorArena* arena = vector_arena_create(4096);
+    VectorAllocator allocator = vector_arena_allocator(arena);
+    assert(vector_arena_used(arena) == 0);
+
+    // The most recent allocation grows in place
+    IntVector* vec = int_vector_create_with(4, &allocator);
+    for (int i = 0; i < 200; i++) {
+        int_vector_push(vec, i);
+    }
+    assert(int_vector_sum(vec) == 199 * 200 / 2);
+    size_t used = vector_arena_used(arena);
+    assert(used < 4096);
+
+    // Many short-lived vectors, spilling over into new blocks
+    for (int round = 0; round < 3; round++) {
+        for (int v = 0; v < 100; v++) {
+            IntVector* tmp = int_vector_create_with(0, &allocator);
+            int_vector_push_n(tmp, v, 50);
+            assert(int_vector_get(tmp, 49) == v);
+        }
+        assert(vector_arena_used(arena) > 4096);
+        assert(int_vector_get(vec, 150) == 150);  // Older vectors are untouched
+
+        // One reset releases everything, no destroy calls needed
+        vector_arena_reset(arena);
+        assert(vector_arena_used(arena) == 0);
+        vec = int_vector_create_with(0, &allocator);
+        int_vector_push_n(vec, 0, 200);
+        for (int i = 0; i < 200; i++) {
+            int_vector_set(vec, i, i);
+        }
+    }
+
+    // Destroying the most recent vector gives its space back
+    used = vector_arena_used(arena);
+    IntVector* last = int_vector_create_with(16, &allocator);
+    int_vector_destroy(last);
+    assert(vector_arena_used(arena) <= used + sizeof(int) * 16 + 64);
+
+    vector_arena_destroy(arena);
+}
+
+static void test_growth_policy() {
+    // Default doubling
+    IntVector* vec = int_vector_create(8);
+    int_vector_push_n(vec, 1, 9);
+    assert(int_vector_capacity(vec) == 16);
+    int_vector_push_n(vec, 1, 8);
+    assert(int_vector_capacity(vec) == 32);
+
+    // 1.5x from here on
+    int_vector_set_growth(vec, VECTOR_GROWTH_HALF, 0);
+    int_vector_push_n(vec, 2, 16);
+    assert(int_vector_capacity(vec) == 48);
+    int_vector_push_n(vec, 3, 16);
+    assert(int_vector_capacity(vec) == 72);
+
+    // Fixed increments, also for a bulk append that needs several
+    int_vector_set_growth(vec, VECTOR_GROWTH_FIXED, 100);
+    int_vector_push_n(vec, 4, 24);
+    assert(int_vector_capacity(vec) == 172);
+    int_vector_push_n(vec, 5, 250);
+    assert(int_vector_capacity(vec) == 372);
+    assert(int_vector_size(vec) == 323);
+    assert(int_vector_get(vec, 48) == 3 && int_vector_get(vec, 322) == 5);
+
+    // Copies keep the policy; release keeps it too
+    IntVector* copy = int_vector_copy(vec);
+    int_vector_push_n(copy, 6, 50);
+    assert(int_vector_capacity(copy) == 472);
+    IntVectorStorage storage;
+    IntVector* local = int_vector_init_storage(&storage, NULL);
+    int_vector_set_growth(local, VECTOR_GROWTH_FIXED, 10);
+    int_vector_push_n(local, 7, 17);
+    assert(int_vector_capacity(local) == 26);
+    int_vector_release(local);
+    int_vector_push_n(local, 7, 17);
+    assert(int_vector_capacity(local) == 26);
+    int_vector_release(local);
+
+    int_vector_destroy(copy);
+    int_vector_destroy(vec);
+}
+
+static void test_large_vectors() {
+    // Crosses VECTOR_PAGE_THRESHOLD: malloc, then a mapping grown in place or by mremap
+    size_t big = VECTOR_PAGE_THRESHOLD / sizeof(int);
+    IntVector* vec = int_vector_create(0);
+    for (size_t i = 0; i < big; i++) {
+        int_vector_push(vec, (int)i);
+    }
+    assert(int_vector_capacity(vec) == big);
+    VectorStats mapped, grown;
+    int_vector_stats(vec, &mapped);
+    for (size_t i = big; i < big + big / 2; i++) {
+        int_vector_push(vec, (int)i);
+    }
+    assert(int_vector_capacity(vec) == 2 * big);
+    for (size_t i = 0; i < big + big / 2; i += 4099) {
+        assert(int_vector_get(vec, i) == (int)i);
+    }
+
+    // Fixed increments on a mapping: no copy per step
+    int_vector_set_growth(vec, VECTOR_GROWTH_FIXED, 1 << 20);
+    int_vector_push_n(vec, -1, big / 2 + 1);
+    assert(int_vector_capacity(vec) == 2 * big + (1 << 20));
+    assert(int_vector_get(vec, 2 * big) == -1);
+    assert(int_vector_get(vec, big) == (int)big);
+
+#ifdef VECTOR_STATS
+    // Once mapped, growth moves pages: the stats must not count it as copying
+    int_vector_stats(vec, &grown);
+    assert(grown.resizes == mapped.resizes + 2);
+    assert(grown.bytes_copied == mapped.bytes_copied);
+#else
+    (void)grown;
+#endif
+
+    // Back below the threshold and into the inline buffer
+    int_vector_remove_range(vec, 1000, int_vector_size(vec) - 1000);
+    int_vector_shrink_to_fit(vec);
+    assert(int_vector_capacity(vec) == 1000);
+    assert(int_vector_get(vec, 999) == 999);
+    int_vector_remove_range(vec, 4, 996);
+    int_vector_shrink_to_fit(vec);
+    assert(int_vector_get(vec, 3) == 3);
+
+    // Large blocks from the allocator interface directly
+    char* block = vector_mem_alloc(NULL, VECTOR_PAGE_THRESHOLD);
+    assert(block != NULL);
+    block[0] = 1;
+    block[VECTOR_PAGE_THRESHOLD - 1] = 2;
+    block = vector_mem_realloc(NULL, block, VECTOR_PAGE_THRESHOLD, 100);
+    assert(block != NULL && block[0] == 1);
+    vector_mem_free(NULL, block, 100);
+
+    int_vector_destroy(vec);
+}
+
+static void test_stats() {
+    VectorStats before, after, s;
+    vector_stats_global(&before);
+
+    IntVector* vec = int_vector_create(0);
+    for (int i = 0; i < 100; i++) {
+        int_vector_push(vec, i);  // Inline up to 16, then 32, 64, 128 on the heap
+    }
+    int_vector_insert(vec, 0, -1);
+    int_vector_remove(vec, 0);
+    int_vector_remove_range(vec, 0, 10);
+    int_vector_stats(vec, &s);
+    int_vector_destroy(vec);
+    vector_stats_global(&after);
+
+#ifdef VECTOR_STATS
+    assert(s.resizes == 3);
+    assert(s.bytes_allocated == (32 + 64 + 128) * sizeof(int));
+    assert(s.bytes_copied >= 16 * sizeof(int) && s.bytes_copied <= (16 + 32 + 64) * sizeof(int));
+    assert(s.bytes_shifted == (100 + 100 + 90) * sizeof(int));
+    assert(s.capacity_bytes == 128 * sizeof(int) && s.peak_bytes == 128 * sizeof(int));
+    assert(s.wasted_bytes == (128 - 90) * sizeof(int));
+    assert(after.resizes - before.resizes == 3);
+    assert(after.bytes_shifted - before.bytes_shifted == s.bytes_shifted);
+    assert(after.wasted_bytes - before.wasted_bytes == (128 - 90) * sizeof(int));
+    assert(after.capacity_bytes == before.capacity_bytes);
+    assert(after.peak_bytes >= 128 * sizeof(int));
+#else
+    // Nothing is counted, and nothing is compiled in to count it
+    assert(s.resizes == 0 && s.bytes_shifted == 0 && s.wasted_bytes == 0);
+    assert(after.resizes == before.resizes && after.bytes_allocated == before.bytes_allocated);
+#endif
+
+    FILE* out = tmpfile();
+    assert(out != NULL);
+    vector_stats_dump(out, "test", &s);
+    vector_stats_dump(out, NULL, NULL);
+    rewind(out);
+    char line[64];
+    assert(fgets(line, sizeof(line), out) && strcmp(line, "test:\n") == 0);
+    assert(fgets(line, sizeof(line), out) && strncmp(line, "  resizes ", 10) == 0);
+    fclose(out);
+}
+
+static void test_small_buffer() {
+    struct alloc_stats stats = {0, 0, 0, 0};
+    VectorAllocator allocator = {counting_alloc, counting_realloc, counting_free, &stats};
+
+    // The first INT_VECTOR_INLINE_CAPACITY ints need no data allocation
+    IntVector* vec = int_vector_create_with(0, &allocator);
+    for (int i = 0; i < INT_VECTOR_INLINE_CAPACITY; i++) {
+        int_vector_push(vec, i);
+    }
+    assert(stats.allocs == 1);
+    assert(int_vector_capacity(vec) == INT_VECTOR_INLINE_CAPACITY);
+
+    // Overflow moves the data to the heap, shrinking moves it back
+    int_vector_push(vec, 16);
+    assert(stats.allocs == 2);
+    assert(int_vector_get(vec, 16) == 16);
+    int_vector_pop(vec);
+    int_vector_remove(vec, 0);
+    int_vector_shrink_to_fit(vec);
+    assert(stats.frees == 1);
+    assert(int_vector_capacity(vec) == 15);
+    assert(int_vector_get(vec, 0) == 1 && int_vector_get(vec, 14) == 15);
+    int_vector_destroy(vec);
+    assert(stats.live == 0);
+
+    // Stack storage: no allocation at all until it overflows
+    IntVectorStorage storage;
+    vec = int_vector_init_storage(&storage, &allocator);
+    stats.allocs = 0;
+    int_vector_push_n(vec, 7, INT_VECTOR_INLINE_CAPACITY);
+    assert(stats.allocs == 0);
+    for (int i = 0; i < 100; i++) {
+        int_vector_push(vec, i);
+    }
+    assert(stats.allocs == 1);
+    assert(int_vector_get(vec, 15) == 7 && int_vector_get(vec, 115) == 99);
+    int_vector_release(vec);
+    assert(stats.live == 0);
+    assert(int_vector_is_empty(vec));
+    int_vector_push(vec, 1);  // Still usable after release
+    int_vector_release(vec);
+
+    // Generated vectors: inline capacity depends on the element size
+    DoubleVector d;
+    double_vector_init(&d, NULL);
+    assert(double_vector_capacity(&d) == VECTOR_INLINE_CAPACITY(double));
+    for (int i = 0; i < 20; i++) {
+        double_vector_push(&d, i);
+    }
+    DoubleVector* dc = double_vector_copy(&d);
+    assert(double_vector_equals(&d, dc));
+    double_vector_release(&d);
+    double_vector_destroy(dc);
+}
+
+static void test_sort() {
+    static int data[5000], expected[5000];
+    unsigned seed = 99;
+    size_t sizes[] = {0, 1, 2, 17, 255, 256, 5000};
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t n = sizes[s];
+        // Random (radix above 256 elements), then inputs that hurt plain quicksort
+        for (int shape = 0; shape < 4; shape++) {
+            for (size_t i = 0; i < n; i++) {
+                seed = seed * 1103515245u + 12345u;
+                switch (shape) {
+                case 0: data[i] = (int)(seed ^ (seed << 16)); break;  // Full range, negatives
+                case 1: data[i] = (int)(n - i); break;                  // Descending
+                case 2: data[i] = (int)(i < n / 2 ? i : n - i); break;  // Organ pipe
+                default: data[i] = (int)(seed >> 16) % 3; break;        // Few distinct
+                }
+            }
+            memcpy(expected, data, n * sizeof(int));
+            qsort(expected, n, sizeof(int), compare_ints);
+
+            IntVector* vec = int_vector_create(n);
+            int_vector_append(vec, data, n);
+            int_vector_sort(vec);
+            for (size_t i = 0; i < n; i++) {
+                assert(int_vector_get(vec, i) == expected[i]);
+            }
+            assert(int_vector_is_sorted(vec));
+            int_vector_destroy(vec);
+        }
+    }
+
+    // Generic introsort, for a type without the radix path
+    DoubleVector* d = double_vector_create(0);
+    double values[1000];
+    for (int i = 0; i < 1000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        values[i] = (double)(seed >> 8) / 3.0 - 1e6;
+        double_vector_push(d, values[i]);
+    }
+    qsort(values, 1000, sizeof(double), compare_doubles);
+    double_vector_sort(d);
+    for (int i = 0; i < 1000; i++) {
+        assert(double_vector_get(d, i) == values[i]);
+    }
+    double_vector_destroy(d);
+}
+
+static void test_sorted_search() {
+    IntVector* vec = int_vector_create(0);
+    int values[] = {9, 1, 5, 5, 5, -4, 12, 1};   // Sorted: -4 1 1 5 5 5 9 12
+    int_vector_append(vec, values, 8);
+    assert(!int_vector_is_sorted(vec));
+    int_vector_sort(vec);
+
+    assert(int_vector_lower_bound(vec, 5) == 3);
+    assert(int_vector_upper_bound(vec, 5) == 6);
+    assert(int_vector_lower_bound(vec, -10) == 0);
+    assert(int_vector_upper_bound(vec, 12) == 8);
+    assert(int_vector_lower_bound(vec, 6) == 6 && int_vector_upper_bound(vec, 6) == 6);
+
+    // Binary search returns the first match, like the linear one
+    assert(int_vector_find(vec, 1) == 1);
+    assert(int_vector_find(vec, 5) == 3);
+    assert(int_vector_find(vec, 12) == 7);
+    assert(int_vector_find(vec, 7) == -1);
+    assert(int_vector_find(vec, 100) == -1);
+
+    // A write that may break the order drops back to the linear search
+    int_vector_set(vec, 0, 50);
+    assert(int_vector_find(vec, 50) == 0);
+    assert(!int_vector_is_sorted(vec));
+    int_vector_set(vec, 0, -4);
+    assert(int_vector_is_sorted(vec));  // Rechecked and remembered
+
+    // dedup keeps one of each run
+    assert(int_vector_dedup(vec) == 3);
+    int unique[] = {-4, 1, 5, 9, 12};
+    assert(int_vector_size(vec) == 5);
+    for (int i = 0; i < 5; i++) {
+        assert(int_vector_get(vec, i) == unique[i]);
+        assert(int_vector_find(vec, unique[i]) == i);
+    }
+
+    IntVector* empty = int_vector_create(0);
+    assert(int_vector_lower_bound(empty, 1) == 0 && int_vector_upper_bound(empty, 1) == 0);
+    assert(int_vector_dedup(empty) == 0);
+    int_vector_sort(empty);
+
+    int_vector_destroy(vec);
+    int_vector_destroy(empty);
+}
+
+static void test_set_operations() {
+    int av[] = {1, 2, 2, 2, 4, 7, 9};
+    int bv[] = {2, 2, 3, 7, 7, 10};
+    int uv[] = {1, 2, 2, 2, 3, 4, 7, 7, 9, 10};
+    int iv[] = {2, 2, 7};
+    int dv[] = {1, 2, 4, 9};
+    IntVector* a = int_vector_create(0);
+    IntVector* b = int_vector_create(0);
+    int_vector_append(a, av, 7);
+    int_vector_append(b, bv, 6);
+
+    IntVector* u = int_vector_set_union(a, b);
+    IntVector* in = int_vector_set_intersection(a, b);
+    IntVector* d = int_vector_set_difference(a, b);
+    assert(int_vector_size(u) == 10 && int_vector_size(in) == 3 && int_vector_size(d) == 4);
+    for (int i = 0; i < 10; i++) assert(int_vector_get(u, i) == uv[i]);
+    for (int i = 0; i < 3; i++) assert(int_vector_get(in, i) == iv[i]);
+    for (int i = 0; i < 4; i++) assert(int_vector_get(d, i) == dv[i]);
+
+    // Results are known sorted, and operations with an empty set are copies or empty
+    assert(int_vector_find(u, 7) == 6);
+    IntVector* empty = int_vector_create(0);
+    IntVector* u2 = int_vector_set_union(empty, a);
+    IntVector* i2 = int_vector_set_intersection(a, empty);
+    IntVector* d2 = int_vector_set_difference(a, empty);
+    assert(int_vector_equals(u2, a) && int_vector_is_empty(i2) && int_vector_equals(d2, a));
+
+    IntVector* all[] = {a, b, u, in, d, empty, u2, i2, d2};
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++) {
+        int_vector_destroy(all[i]);
+    }
+}
+
+static int64_t max_op(int64_t acc, int64_t value) {
+    return value > acc ? value : acc;
+}
+
+static int double_plus(int value, void *ctx) {
+    return value * 2 + *(const int *)ctx;
+}
+
+static bool is_multiple(int value, void *ctx) {
+    return value % *(const int *)ctx == 0;
+}
+
+static void test_parallel() {
+    // Small grain, so a modest vector is split across several threads
+    vector_parallel_set_threads(4);
+    vector_parallel_set_grain(1000);
+    assert(vector_parallel_threads() >= 1);
+    assert(vector_parallel_chunks(1999) == 1);  // Under two grains: serial
+    assert(vector_parallel_chunks(100000) > 1 || vector_parallel_threads() == 1);
+
+    size_t n = 100003;
+    IntVector* vec = int_vector_create(n);
+    unsigned seed = 7;
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int_vector_push(vec, (int)(seed >> 12) - (1 << 19));
+    }
+    IntVector* serial = int_vector_copy(vec);
+
+    assert(int_vector_parallel_sum(vec) == int_vector_sum(vec));
+    assert(int_vector_parallel_reduce(vec, INT64_MIN, max_op) == int_vector_max(vec));
+
+    // Sort: same as the serial sort
+    int_vector_parallel_sort(vec);
+    int_vector_sort(serial);
+    assert(int_vector_equals(vec, serial));
+    assert(int_vector_find(vec, int_vector_get(serial, 500)) <= 500);
+
+    // Filter keeps the order, and the result is sorted like its input
+    int three = 3;
+    IntVector* multiples = int_vector_parallel_filter(vec, is_multiple, &three);
+    size_t expected = 0;
+    for (size_t i = 0; i < n; i++) {
+        int value = int_vector_get(vec, i);
+        if (value % 3 == 0) {
+            assert(int_vector_get(multiples, expected++) == value);
+        }
+    }
+    assert(int_vector_size(multiples) == expected);
+
+    // Transform and prefix sum against plain loops
+    int one = 1;
+    int_vector_parallel_transform(multiples, double_plus, &one);
+    int_vector_parallel_prefix_sum(multiples);
+    unsigned running = 0;
+    size_t k = 0;
+    for (size_t i = 0; i < n; i++) {
+        int value = int_vector_get(serial, i);
+        if (value % 3 != 0) continue;
+        running += (unsigned)value * 2u + 1u;  // Sums wrap
+        assert(int_vector_get(multiples, k++) == (int)running);
+    }
+
+    // One thread: everything runs on the caller with the same results
+    vector_parallel_set_threads(1);
+    assert(vector_parallel_threads() == 1);
+    IntVector* again = int_vector_parallel_filter(vec, is_multiple, &three);
+    assert(int_vector_size(again) == expected);
+
+    vector_parallel_set_threads(0);
+    vector_parallel_set_grain(0);
+    assert(vector_parallel_grain() == VECTOR_PARALLEL_GRAIN);
+    int_vector_destroy(vec);
+    int_vector_destroy(serial);
+    int_vector_destroy(multiples);
+    int_vector_destroy(again);
+}
+
+static void test_persistence() {
+    const char *path = "test_vector.ivec";
+    IntVector* vec = int_vector_create(0);
+    for (int i = 0; i < 1000; i++) {
+        int_vector_push(vec, i * 3 - 500);
+    }
+    int_vector_sort(vec);
+    assert(int_vector_save(vec, path));
+
+    // load: an ordinary heap vector, sorted flag restored
+    IntVector* loaded = int_vector_load(path);
+    assert(loaded != NULL);
+    assert(int_vector_equals(vec, loaded));
+    assert(int_vector_is_sorted(loaded));
+    int_vector_push(loaded, 1);
+    int_vector_destroy(loaded);
+
+    // Read-only mapping: the data is the file
+    IntVector* mapped = int_vector_open_mmap(path, VECTOR_MAP_READ_ONLY | VECTOR_MAP_VERIFY);
+    assert(mapped != NULL);
+    assert(int_vector_equals(vec, mapped));
+    assert(int_vector_find(mapped, 97) == 199);
+    IntVector* copy = int_vector_copy(mapped);  // Shares the mapping's allocator
+    int_vector_destroy(mapped);
+    assert(int_vector_equals(vec, copy));
+    int_vector_destroy(copy);
+
+    // Copy-on-write: writes stay private, growing moves the data to the heap
+    mapped = int_vector_open_mmap(path, VECTOR_MAP_COPY_ON_WRITE);
+    assert(mapped != NULL);
+    int_vector_set(mapped, 0, 12345);
+    int_vector_push(mapped, 7);
+    assert(int_vector_get(mapped, 0) == 12345 && int_vector_get(mapped, 999) == 2497);
+    assert(int_vector_size(mapped) == 1001);
+    int_vector_destroy(mapped);
+    loaded = int_vector_load(path);
+    assert(int_vector_equals(vec, loaded));  // File unchanged
+    int_vector_destroy(loaded);
+
+    // Corrupt one element: caught by load and by a verified mapping only
+    FILE *f = fopen(path, "r+b");
+    assert(f != NULL);
+    fseek(f, VECTOR_FILE_HEADER_SIZE + 40, SEEK_SET);
+    fputc(0x55, f);
+    fclose(f);
+    errno = 0;
+    assert(int_vector_load(path) == NULL && errno == EINVAL);
+    assert(int_vector_open_mmap(path, VECTOR_MAP_READ_ONLY | VECTOR_MAP_VERIFY) == NULL);
+    mapped = int_vector_open_mmap(path, VECTOR_MAP_READ_ONLY);
+    assert(mapped != NULL);
+    int_vector_destroy(mapped);
+
+    // Truncated and missing files
+    f = fopen(path, "wb");
+    fputs("IVEC", f);
+    fclose(f);
+    assert(int_vector_load(path) == NULL && errno == EINVAL);
+    remove(path);
+    assert(int_vector_open_mmap(path, VECTOR_MAP_READ_ONLY) == NULL && errno == ENOENT);
+
+    // Empty vectors round-trip too
+    IntVector* empty = int_vector_create(0);
+    assert(int_vector_save(empty, path));
+    loaded = int_vector_load(path);
+    assert(loaded != NULL && int_vector_is_empty(loaded));
+    mapped = int_vector_open_mmap(path, VECTOR_MAP_COPY_ON_WRITE);
+    int_vector_push(mapped, 3);
+    assert(int_vector_get(mapped, 0) == 3);
+    remove(path);
+
+    int_vector_destroy(empty);
+    int_vector_destroy(loaded);
+    int_vector_destroy(mapped);
+    int_vector_destroy(vec);
+}
+
+static void test_compressed() {
+    // Sorted, dense IDs with repeats: a few bits per value
+    IntVector* ids = int_vector_create(0);
+    unsigned seed = 3;
+    int id = -1000;
+    for (int i = 0; i < 10000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        id += (int)((seed >> 16) % 5);  // Gaps 0..4
+        int_vector_push(ids, id);
+    }
+    CompressedIntVector* cv = int_vector_compress(ids);
+    assert(cv != NULL);
+    assert(compressed_int_vector_size(cv) == 10000);
+    assert(compressed_int_vector_is_sorted(cv));
+    assert(compressed_int_vector_bytes(cv) * 6 < 10000 * sizeof(int));
+
+    IntVector* back = int_vector_decompress(cv);
+    assert(int_vector_equals(ids, back));
+    for (size_t i = 0; i < 10000; i += 37) {
+        assert(compressed_int_vector_get(cv, i) == int_vector_get(ids, i));
+    }
+    int_vector_sort(ids);  // Known sorted, for the reference searches
+    for (int value = -1001; value <= id + 1; value += 7) {
+        assert(compressed_int_vector_lower_bound(cv, value) == int_vector_lower_bound(ids, value));
+        assert(compressed_int_vector_find(cv, value) == int_vector_find(ids, value));
+    }
+
+    // Unsorted values across the whole int range, size not a multiple of the block
+    IntVector* mixed = int_vector_create(0);
+    int extremes[] = {INT_MIN, INT_MAX, 0, -1, INT_MAX, INT_MIN};
+    int_vector_append(mixed, extremes, 6);
+    for (int i = 0; i < 1000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int_vector_push(mixed, (int)seed);
+    }
+    CompressedIntVector* cm = int_vector_compress(mixed);
+    assert(!compressed_int_vector_is_sorted(cm));
+    assert(compressed_int_vector_blocks(cm) == (1006 + COMPRESSED_BLOCK_SIZE - 1) / COMPRESSED_BLOCK_SIZE);
+    IntVector* mixed_back = int_vector_decompress(cm);
+    assert(int_vector_equals(mixed, mixed_back));
+    assert(compressed_int_vector_get(cm, 1005) == int_vector_get(mixed, 1005));
+    assert(compressed_int_vector_find(cm, INT_MAX) == 1);
+    assert(compressed_int_vector_find(cm, int_vector_get(mixed, 900)) == int_vector_find(mixed, int_vector_get(mixed, 900)));
+    int block[COMPRESSED_BLOCK_SIZE];
+    assert(compressed_int_vector_decode_block(cm, 7, block) == 1006 - 7 * COMPRESSED_BLOCK_SIZE);
+    assert(block[0] == int_vector_get(mixed, 7 * COMPRESSED_BLOCK_SIZE));
+
+    // Empty
+    IntVector* empty = int_vector_create(0);
+    CompressedIntVector* ce = int_vector_compress(empty);
+    assert(compressed_int_vector_size(ce) == 0 && compressed_int_vector_blocks(ce) == 0);
+    assert(compressed_int_vector_find(ce, 1) == -1);
+    IntVector* empty_back = int_vector_decompress(ce);
+    assert(int_vector_is_empty(empty_back));
+
+    compressed_int_vector_destroy(cv);
+    compressed_int_vector_destroy(cm);
+    compressed_int_vector_destroy(ce);
+    IntVector* all[] = {ids, back, mixed, mixed_back, empty, empty_back};
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++) {
+        int_vector_destroy(all[i]);
+    }
+}
+
+static void test_deque() {
+    IntDeque* dq = int_deque_create(0);
+    assert(dq != NULL);
+    assert(int_deque_is_empty(dq));
+    assert(int_deque_capacity(dq) == 8);
+
+    // Both ends
+    int_deque_push_back(dq, 2);
+    int_deque_push_back(dq, 3);
+    int_deque_push_front(dq, 1);
+    int_deque_push_front(dq, 0);
+    assert(int_deque_size(dq) == 4);
+    assert(int_deque_front(dq) == 0 && int_deque_back(dq) == 3);
+    for (size_t i = 0; i < 4; i++) assert(int_deque_get(dq, i) == (int)i);
+    assert(int_deque_pop_front(dq) == 0);
+    assert(int_deque_pop_back(dq) == 3);
+    int_deque_set(dq, 1, 20);
+    assert(int_deque_get(dq, 0) == 1 && int_deque_get(dq, 1) == 20);
+
+    // Sliding window: wraps around many times, capacity stays put
+    int_deque_clear(dq);
+    for (int i = 0; i < 1000; i++) {
+        int_deque_push_back(dq, i);
+        if (int_deque_size(dq) > 5) assert(int_deque_pop_front(dq) == i - 5);
+    }
+    assert(int_deque_capacity(dq) == 8);
+    assert(int_deque_front(dq) == 995 && int_deque_back(dq) == 999);
+
+    // Growing while wrapped keeps the order; linearize then rotates it
+    for (int i = 1; i <= 20; i++) int_deque_push_front(dq, 995 - i);
+    int values[] = {1000, 1001, 1002};
+    int_deque_append(dq, values, 3);
+    assert(int_deque_size(dq) == 28);
+    assert(int_deque_capacity(dq) == 32);
+    for (size_t i = 0; i < 28; i++) assert(int_deque_get(dq, i) == 975 + (int)i);
+    int* flat = int_deque_linearize(dq);
+    for (size_t i = 0; i < 28; i++) assert(flat[i] == 975 + (int)i);
+
+    IntVector* vec = int_deque_to_vector(dq);
+    assert(int_vector_size(vec) == 28);
+    assert(int_vector_get(vec, 0) == 975 && int_vector_get(vec, 27) == 1002);
+
+    // Append across the end of the buffer
+    for (int i = 0; i < 20; i++) int_deque_pop_front(dq);
+    int many[40];
+    for (int i = 0; i < 40; i++) many[i] = 1003 + i;
+    int_deque_append(dq, many, 20);
+    assert(int_deque_capacity(dq) == 32);
+    int_deque_append(dq, many + 20, 20);
+    assert(int_deque_size(dq) == 48 && int_deque_capacity(dq) == 64);
+    for (size_t i = 0; i < 48; i++) assert(int_deque_get(dq, i) == 995 + (int)i);
+
+    int_deque_reserve(dq, 100);
+    assert(int_deque_capacity(dq) == 128);
+    assert(int_deque_back(dq) == 1042);
+
+    // Allocations come from the allocator and balance out
+    struct alloc_stats stats = {0, 0, 0, 0};
+    VectorAllocator counting = {counting_alloc, counting_realloc, counting_free, &stats};
+    IntDeque* counted = int_deque_create_with(3, &counting);
+    assert(int_deque_capacity(counted) == 8);
+    for (int i = 0; i < 100; i++) int_deque_push_front(counted, i);
+    assert(int_deque_back(counted) == 0 && int_deque_front(counted) == 99);
+    int_deque_destroy(counted);
+    assert(stats.live == 0 && stats.allocs == stats.frees);
+
+    int_vector_destroy(vec);
+    int_deque_destroy(dq);
+}
+
+#define PRODUCERS 4
+#define PER_PRODUCER 20000
+
+struct producer {
+    ConcurrentIntVector* cv;
+    int id;
+};
+
+static void* produce(void* arg) {
+    struct producer* p = arg;
+    int base = p->id * 1000000;
+    for (int i = 0; i < PER_PRODUCER; ) {
+        if (p->id % 2 == 0 || PER_PRODUCER - i < 7) {
+            size_t at = concurrent_int_vector_push(p->cv, base + i);
+            assert(concurrent_int_vector_get(p->cv, at) == base + i);
+            i++;
+        } else {
+            int batch[7];
+            for (int j = 0; j < 7; j++) batch[j] = base + i + j;
+            size_t at = concurrent_int_vector_append(p->cv, batch, 7);
+            assert(concurrent_int_vector_get(p->cv, at + 6) == base + i + 6);
+            i += 7;
+        }
+    }
+    return NULL;
+}
+
+/* Each producer's values appear in the order it appended them */
+static void check_producer_order(const IntVector* vec) {
+    int next[PRODUCERS] = {0};
+    for (size_t i = 0; i < int_vector_size(vec); i++) {
+        int value = int_vector_get(vec, i);
+        int id = value / 1000000;
+        assert(id >= 0 && id < PRODUCERS);
+        assert(value % 1000000 == next[id]);
+        next[id]++;
+    }
+}
+
+static void test_concurrent() {
+    ConcurrentIntVector* cv = concurrent_int_vector_create();
+    assert(cv != NULL);
+    assert(concurrent_int_vector_size(cv) == 0);
+
+    pthread_t threads[PRODUCERS];
+    struct producer producers[PRODUCERS];
+    for (int t = 0; t < PRODUCERS; t++) {
+        producers[t].cv = cv;
+        producers[t].id = t;
+        assert(pthread_create(&threads[t], NULL, produce, &producers[t]) == 0);
+    }
+
+    // Snapshots taken while the producers run are consistent prefixes
+    size_t last = 0;
+    for (int i = 0; i < 20; i++) {
+        IntVector* snap = concurrent_int_vector_snapshot(cv);
+        assert(snap != NULL);
+        assert(int_vector_size(snap) >= last);
+        last = int_vector_size(snap);
+        check_producer_order(snap);
+        int_vector_destroy(snap);
+
+        // Every index below size() has been written
+        size_t n = concurrent_int_vector_size(cv);
+        IntVector* seen = int_vector_create(n);
+        for (size_t j = 0; j < n; j++) {
+            int_vector_push(seen, concurrent_int_vector_get(cv, j));
+        }
+        check_producer_order(seen);
+        int_vector_destroy(seen);
+    }
+
+    for (int t = 0; t < PRODUCERS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    assert(concurrent_int_vector_size(cv) == PRODUCERS * PER_PRODUCER);
+
+    IntVector* frozen = concurrent_int_vector_freeze(cv);
+    assert(int_vector_size(frozen) == PRODUCERS * PER_PRODUCER);
+    check_producer_order(frozen);
+    int_vector_destroy(frozen);
+
+    // Empty freeze
+    IntVector* empty = concurrent_int_vector_freeze(concurrent_int_vector_create());
+    assert(int_vector_is_empty(empty));
+    int_vector_destroy(empty);
+}
+
 int main() {
     printf("========================================\n");
-    printf("       IntVector Test Suite\n");
+    printf("       IntVector Test Suite (SIMD: %s)\n", vector_simd_name());
     printf("========================================\n\n");
     
     // Run all tests
@@ -251,6 +1263,25 @@ int main() {
     RUN_TEST(test_search);
     RUN_TEST(test_utilities);
     RUN_TEST(test_edge_cases);
+    RUN_TEST(test_bulk_operations);
+    RUN_TEST(test_bulk_self_insert);
+    RUN_TEST(test_reductions);
+    RUN_TEST(test_simd_kernels_agree);
+    RUN_TEST(test_generic_types);
+    RUN_TEST(test_allocator);
+    RUN_TEST(test_arena);
+    RUN_TEST(test_small_buffer);
+    RUN_TEST(test_growth_policy);
+    RUN_TEST(test_large_vectors);
+    RUN_TEST(test_stats);
+    RUN_TEST(test_sort);
+    RUN_TEST(test_sorted_search);
+    RUN_TEST(test_set_operations);
+    RUN_TEST(test_parallel);
+    RUN_TEST(test_persistence);
+    RUN_TEST(test_compressed);
+    RUN_TEST(test_concurrent);
+    RUN_TEST(test_deque);
     
     printf("\n========================================\n");
     printf("All %d tests passed!\n", tests_passed);
@@ -0,0 +1,389 @@
+#define _POSIX_C_SOURCE 200809L // for clock_gettime(), mkstemp() and fork()
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_RDTSC 1
+#endif
+#include "libwc.h"
+
+/*
+ * bench_wc - Throughput benchmark for libwc and my_wc
+ *
+ * Generates one deterministic corpus per input class, then measures:
+ * - libwc: wc_feed() over the corpus in memory, in the same 128 KiB pieces
+ *   count_stream() reads, best of LIB_RUNS
+ * - my_wc: the full binary (exec, read(), counting, output) on the corpus
+ *   written to a temporary file, best of BIN_RUNS
+ *
+ * Results are GB/s plus TSC cycles per byte for libwc. With --baseline=FILE
+ * each result is compared against a file written earlier with --save=FILE.
+ * MY_WC_KERNEL selects the kernel for both, as for my_wc itself.
+ */
+
+#define DEFAULT_SIZE_MB 64
+#define PIECE_SIZE (128 * 1024)     // Matches READ_BUFFER_SIZE in my_wc.c
+#define LIB_RUNS 5
+#define BIN_RUNS 3
+#define NOISE_PERCENT 5.0           // Smaller changes are reported as "~"
+
+struct corpus {
+	const char *name;
+	void (*generate)(unsigned char *buf, size_t size);
+};
+
+struct result {
+	char name[32];
+	double lib_gbps;
+	double lib_cycles_per_byte;
+	double bin_gbps;
+};
+
+
+// Corpus generators (fixed seeds: every run benchmarks the same bytes)
+static uint32_t rng_state;
+
+static uint32_t rng(void) {
+	rng_state = rng_state * 1103515245u + 12345u;
+	return rng_state >> 8;
+}
+
+/* Append s to buf at *pos unless it would pass size; false once full */
+static int put(unsigned char *buf, size_t size, size_t *pos, const char *s) {
+	size_t len = strlen(s);
+	if (*pos + len > size) return 0;
+	memcpy(buf + *pos, s, len);
+	*pos += len;
+	return 1;
+}
+
+static void fill_tail(unsigned char *buf, size_t size, size_t pos) {
+	memset(buf + pos, ' ', size - pos);
+}
+
+/* English-like words, punctuation, lines of about 70 columns */
+static void gen_prose(unsigned char *buf, size_t size) {
+	static const char *words[] = {"the", "of", "and", "a", "to", "in", "is", "that", "counting",
+	                              "words", "file", "bytes", "quickly", "line", "buffer", "system"};
+	size_t pos = 0, column = 0;
+
+	rng_state = 1;
+	for (;;) {
+		const char *w = words[rng() % (sizeof(words) / sizeof(words[0]))];
+		if (!put(buf, size, &pos, w)) break;
+		column += strlen(w);
+
+		const char *sep = rng() % 12 == 0 ? ". " : " ";
+		if (column > 70) {
+			sep = "\n";
+			column = 0;
+		}
+		if (!put(buf, size, &pos, sep)) break;
+		column += strlen(sep);
+	}
+	fill_tail(buf, size, pos);
+}
+
+/* Short tokens between long runs of spaces, tabs and blank lines */
+static void gen_whitespace(unsigned char *buf, size_t size) {
+	static const char ws[] = " \t\n \r ";
+	size_t pos = 0;
+
+	rng_state = 2;
+	while (pos < size) {
+		size_t run = 1 + rng() % 16;
+		for (size_t i = 0; i < run && pos < size; i++) {
+			buf[pos++] = (unsigned char)ws[rng() % (sizeof(ws) - 1)];
+		}
+		if (pos < size && rng() % 2) {
+			buf[pos++] = (unsigned char)('a' + rng() % 26);
+		}
+	}
+}
+
+/* Prose with a newline only every ~1 MiB */
+static void gen_long_lines(unsigned char *buf, size_t size) {
+	gen_prose(buf, size);
+	for (size_t i = 0; i < size; i++) {
+		if (buf[i] == '\n') buf[i] = (i % (1024 * 1024)) < 70 ? '\n' : ' ';
+	}
+}
+
+/* Cyrillic, CJK and emoji words; Unicode spaces among the ASCII ones */
+static void gen_utf8(unsigned char *buf, size_t size) {
+	static const char *words[] = {"привет", "мир", "счёт", "文字", "数える", "ファイル", "\xf0\x9f\x98\x80",
+	                              "caf\xc3\xa9", "na\xc3\xafve", "text"};
+	static const char *spaces[] = {" ", " ", " ", "\n", "\xe3\x80\x80", "\xe2\x80\x83", "\t"};
+	size_t pos = 0;
+
+	rng_state = 3;
+	for (;;) {
+		if (!put(buf, size, &pos, words[rng() % (sizeof(words) / sizeof(words[0]))])) break;
+		if (!put(buf, size, &pos, spaces[rng() % (sizeof(spaces) / sizeof(spaces[0]))])) break;
+	}
+	fill_tail(buf, size, pos);
+}
+
+/* Uniformly random bytes (compressed or executable data) */
+static void gen_binary(unsigned char *buf, size_t size) {
+	rng_state = 4;
+	for (size_t i = 0; i < size; i++) {
+		buf[i] = (unsigned char)rng();
+	}
+}
+
+static const struct corpus corpora[] = {
+	{"ascii-prose", gen_prose},
+	{"whitespace", gen_whitespace},
+	{"long-lines", gen_long_lines},
+	{"utf8", gen_utf8},
+	{"binary", gen_binary},
+};
+#define NCORPORA (sizeof(corpora) / sizeof(corpora[0]))
+
+
+// Timing
+static double now_seconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t cycles(void) {
+#ifdef HAVE_RDTSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static volatile uintmax_t sink;  // Keeps the counts (and so the counting) alive
+
+static void bench_lib(const unsigned char *buf, size_t size, struct result *r) {
+	double best = 1e30;
+	uint64_t best_cycles = 0;
+
+	for (int run = 0; run < LIB_RUNS; run++) {
+		struct wc_state st;
+		double start = now_seconds();
+		uint64_t c0 = cycles();
+
+		wc_init(&st, 0);
+		for (size_t off = 0; off < size; off += PIECE_SIZE) {
+			wc_feed(&st, buf + off, size - off < PIECE_SIZE ? size - off : PIECE_SIZE);
+		}
+		struct wc_counts counts = wc_finish(&st);
+
+		uint64_t c1 = cycles();
+		double elapsed = now_seconds() - start;
+		sink += counts.words;
+
+		if (elapsed < best) {
+			best = elapsed;
+			best_cycles = c1 - c0;
+		}
+	}
+
+	r->lib_gbps = size / best / 1e9;
+	r->lib_cycles_per_byte = (double)best_cycles / size;
+}
+
+/* Run "binary path" with output to /dev/null; wall time, or -1 if it failed */
+static double run_binary(const char *binary, const char *path) {
+	double start = now_seconds();
+	pid_t pid = fork();
+	int status;
+
+	if (pid < 0) return -1;
+	if (pid == 0) {
+		int devnull = open("/dev/null", O_WRONLY);
+		if (devnull >= 0) dup2(devnull, STDOUT_FILENO);
+		execl(binary, binary, path, (char *)NULL);
+		_exit(127);
+	}
+
+	if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		return -1;
+	}
+	return now_seconds() - start;
+}
+
+static int bench_bin(const char *binary, const unsigned char *buf, size_t size, struct result *r) {
+	char path[] = "/tmp/bench_wc.XXXXXX";
+	int fd = mkstemp(path);
+	double best = 1e30;
+
+	if (fd < 0) {
+		perror("bench_wc: mkstemp");
+		return -1;
+	}
+	for (size_t done = 0; done < size; ) {
+		ssize_t n = write(fd, buf + done, size - done);
+		if (n <= 0) {
+			perror("bench_wc: write");
+			close(fd);
+			unlink(path);
+			return -1;
+		}
+		done += (size_t)n;
+	}
+	close(fd);
+
+	run_binary(binary, path);  // Warm the page cache
+	for (int run = 0; run < BIN_RUNS; run++) {
+		double elapsed = run_binary(binary, path);
+		if (elapsed < 0) {
+			fprintf(stderr, "bench_wc: '%s' failed\n", binary);
+			unlink(path);
+			return -1;
+		}
+		if (elapsed < best) best = elapsed;
+	}
+
+	unlink(path);
+	r->bin_gbps = size / best / 1e9;
+	return 0;
+}
+
+
+// Baseline files: one "name lib_gbps lib_cycles_per_byte bin_gbps" line per corpus
+static int save_baseline(const char *path, const struct result *results, size_t count) {
+	FILE *fp = fopen(path, "w");
+	if (fp == NULL) {
+		fprintf(stderr, "bench_wc: cannot write '%s': %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	fprintf(fp, "# bench_wc baseline (kernel: %s)\n", wc_kernel_name());
+	for (size_t i = 0; i < count; i++) {
+		fprintf(fp, "%s %.3f %.4f %.3f\n", results[i].name, results[i].lib_gbps,
+		        results[i].lib_cycles_per_byte, results[i].bin_gbps);
+	}
+
+	return fclose(fp) == 0 ? 0 : -1;
+}
+
+static size_t load_baseline(const char *path, struct result *baseline, size_t max) {
+	FILE *fp = fopen(path, "r");
+	char line[256];
+	size_t count = 0;
+
+	if (fp == NULL) return 0;
+	while (count < max && fgets(line, sizeof(line), fp) != NULL) {
+		struct result *b = &baseline[count];
+		if (line[0] != '#' && sscanf(line, "%31s %lf %lf %lf", b->name, &b->lib_gbps,
+		                             &b->lib_cycles_per_byte, &b->bin_gbps) == 4) {
+			count++;
+		}
+	}
+
+	fclose(fp);
+	return count;
+}
+
+static void print_change(double now, double before) {
+	double percent = before > 0 ? (now - before) / before * 100.0 : 0;
+
+	if (before <= 0) {
+		printf("  %8s", "-");
+	} else if (percent > -NOISE_PERCENT && percent < NOISE_PERCENT) {
+		printf("  %7s~", "");
+	} else {
+		printf("  %+7.1f%%", percent);
+	}
+}
+
+
+static void usage(const char *prog_name) {
+	fprintf(stderr, "Usage: %s [--size=MB] [--binary=PATH] [--baseline=FILE] [--save=FILE]\n", prog_name);
+}
+
+int main(int argc, char *argv[]) {
+	size_t size_mb = DEFAULT_SIZE_MB;
+	const char *binary = "./my_wc";
+	const char *baseline_path = NULL;
+	const char *save_path = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "--size=", 7) == 0 && atoi(argv[i] + 7) > 0) {
+			size_mb = (size_t)atoi(argv[i] + 7);
+		} else if (strncmp(argv[i], "--binary=", 9) == 0) {
+			binary = argv[i] + 9;
+		} else if (strncmp(argv[i], "--baseline=", 11) == 0) {
+			baseline_path = argv[i] + 11;
+		} else if (strncmp(argv[i], "--save=", 7) == 0) {
+			save_path = argv[i] + 7;
+		} else {
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	size_t size = size_mb * 1024 * 1024;
+	unsigned char *buf = malloc(size);
+	if (buf == NULL) {
+		fprintf(stderr, "bench_wc: cannot allocate %zu MiB\n", size_mb);
+		return EXIT_FAILURE;
+	}
+
+	struct result results[NCORPORA];
+	struct result baseline[NCORPORA];
+	size_t nbaseline = baseline_path != NULL ? load_baseline(baseline_path, baseline, NCORPORA) : 0;
+
+	wc_select_kernel(getenv("MY_WC_KERNEL"));
+	printf("bench_wc: %zu MiB per corpus, kernel %s%s\n", size_mb, wc_kernel_name(),
+#ifdef HAVE_RDTSC
+	       ""
+#else
+	       " (no cycle counter)"
+#endif
+	      );
+	if (baseline_path != NULL && nbaseline == 0) {
+		printf("No baseline in '%s' yet (make bench-save writes one)\n", baseline_path);
+	}
+	printf("\n%-12s  %10s  %8s  %10s", "corpus", "libwc GB/s", "cyc/byte", "my_wc GB/s");
+	if (nbaseline > 0) printf("  %9s  %9s", "libwc vs", "my_wc vs");
+	printf("\n");
+
+	int status = EXIT_SUCCESS;
+	for (size_t c = 0; c < NCORPORA; c++) {
+		struct result *r = &results[c];
+
+		snprintf(r->name, sizeof(r->name), "%s", corpora[c].name);
+		corpora[c].generate(buf, size);
+		bench_lib(buf, size, r);
+		if (bench_bin(binary, buf, size, r) != 0) {
+			status = EXIT_FAILURE;
+			r->bin_gbps = 0;
+		}
+
+		printf("%-12s  %10.2f  %8.3f  %10.2f", r->name, r->lib_gbps, r->lib_cycles_per_byte, r->bin_gbps);
+		for (size_t b = 0; b < nbaseline; b++) {
+			if (strcmp(baseline[b].name, r->name) == 0) {
+				print_change(r->lib_gbps, baseline[b].lib_gbps);
+				print_change(r->bin_gbps, baseline[b].bin_gbps);
+			}
+		}
+		printf("\n");
+		fflush(stdout);
+	}
+
+	if (save_path != NULL) {
+		if (save_baseline(save_path, results, NCORPORA) == 0) {
+			printf("\nBaseline saved to '%s'\n", save_path);
+		} else {
+			status = EXIT_FAILURE;
+		}
+	}
+
+	free(buf);
+	return status;
+}
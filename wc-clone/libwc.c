@@ -0,0 +1,530 @@
+#include "libwc.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+/*
+ * Counting kernels
+ *
+ * A kernel counts lines, words and characters in one buffer and carries
+ * the word state (was the previous character whitespace?) to the next
+ * call. Byte totals and the last byte are tracked by wc_feed().
+ *
+ * Input is treated as UTF-8:
+ *   - A character is any byte that is not a continuation byte (10xxxxxx).
+ *   - Whitespace is the C locale isspace() set (' ', '\t', '\n', '\v', '\f',
+ *     '\r') plus the multibyte Unicode spaces glibc's iswspace() accepts:
+ *     U+1680, U+2000..U+2006, U+2008..U+200A, U+2028, U+2029, U+205F and
+ *     U+3000. All of them are 3-byte sequences led by 0xE1, 0xE2 or 0xE3,
+ *     so a lead byte is held in st->pending until the sequence is decided.
+ *
+ * The SIMD kernels classify 64 bytes at a time into bitmasks:
+ *   newline_mask - bit i set if byte i is '\n'
+ *   space_mask   - bit i set if byte i is ASCII whitespace
+ *   cont_mask    - bit i set if byte i is a UTF-8 continuation byte
+ *   ctrl_mask    - bit i set if byte i is a control byte (< 0x20 or 0x7F)
+ *   lead_mask    - bit i set if byte i may start a multibyte space
+ * A word starts at every non-space byte whose predecessor is a space, so
+ *   starts = ~space_mask & ((space_mask << 1) | previous_block_ended_in_space)
+ * and lines, words and characters are each a popcount away. A block with a
+ * possible multibyte space (rare outside of CJK text) goes through the
+ * scalar kernel instead, as does a block that begins inside such a sequence.
+ *
+ * -L (maximum line length) is tracked in the same pass when requested:
+ * each character is one column, a tab advances to the next multiple of 8,
+ * '\n', '\r' and '\f' end the line and other control bytes take no space.
+ */
+typedef void (*count_kernel_fn)(struct wc_state *st, const unsigned char *buf, size_t len);
+
+enum {
+	CLASS_SPACE = 1,            // ASCII whitespace
+	CLASS_CONT = 2,             // UTF-8 continuation byte
+	CLASS_LEAD = 4,             // Lead byte of a possible multibyte space (0xE1..0xE3)
+	CLASS_CTRL = 8,             // Control byte: zero width, or a tab/line break for -L
+};
+
+static const unsigned char byte_class[256] = {
+	[0x00] = CLASS_CTRL, [0x01] = CLASS_CTRL, [0x02] = CLASS_CTRL, [0x03] = CLASS_CTRL,
+	[0x04] = CLASS_CTRL, [0x05] = CLASS_CTRL, [0x06] = CLASS_CTRL, [0x07] = CLASS_CTRL,
+	[0x08] = CLASS_CTRL, [0x0E] = CLASS_CTRL, [0x0F] = CLASS_CTRL, [0x10] = CLASS_CTRL,
+	[0x11] = CLASS_CTRL, [0x12] = CLASS_CTRL, [0x13] = CLASS_CTRL, [0x14] = CLASS_CTRL,
+	[0x15] = CLASS_CTRL, [0x16] = CLASS_CTRL, [0x17] = CLASS_CTRL, [0x18] = CLASS_CTRL,
+	[0x19] = CLASS_CTRL, [0x1A] = CLASS_CTRL, [0x1B] = CLASS_CTRL, [0x1C] = CLASS_CTRL,
+	[0x1D] = CLASS_CTRL, [0x1E] = CLASS_CTRL, [0x1F] = CLASS_CTRL, [0x7F] = CLASS_CTRL,
+	['\t'] = CLASS_SPACE | CLASS_CTRL, ['\n'] = CLASS_SPACE | CLASS_CTRL,
+	['\v'] = CLASS_SPACE | CLASS_CTRL, ['\f'] = CLASS_SPACE | CLASS_CTRL,
+	['\r'] = CLASS_SPACE | CLASS_CTRL, [' '] = CLASS_SPACE,
+	[0x80] = CLASS_CONT, [0x81] = CLASS_CONT, [0x82] = CLASS_CONT, [0x83] = CLASS_CONT,
+	[0x84] = CLASS_CONT, [0x85] = CLASS_CONT, [0x86] = CLASS_CONT, [0x87] = CLASS_CONT,
+	[0x88] = CLASS_CONT, [0x89] = CLASS_CONT, [0x8A] = CLASS_CONT, [0x8B] = CLASS_CONT,
+	[0x8C] = CLASS_CONT, [0x8D] = CLASS_CONT, [0x8E] = CLASS_CONT, [0x8F] = CLASS_CONT,
+	[0x90] = CLASS_CONT, [0x91] = CLASS_CONT, [0x92] = CLASS_CONT, [0x93] = CLASS_CONT,
+	[0x94] = CLASS_CONT, [0x95] = CLASS_CONT, [0x96] = CLASS_CONT, [0x97] = CLASS_CONT,
+	[0x98] = CLASS_CONT, [0x99] = CLASS_CONT, [0x9A] = CLASS_CONT, [0x9B] = CLASS_CONT,
+	[0x9C] = CLASS_CONT, [0x9D] = CLASS_CONT, [0x9E] = CLASS_CONT, [0x9F] = CLASS_CONT,
+	[0xA0] = CLASS_CONT, [0xA1] = CLASS_CONT, [0xA2] = CLASS_CONT, [0xA3] = CLASS_CONT,
+	[0xA4] = CLASS_CONT, [0xA5] = CLASS_CONT, [0xA6] = CLASS_CONT, [0xA7] = CLASS_CONT,
+	[0xA8] = CLASS_CONT, [0xA9] = CLASS_CONT, [0xAA] = CLASS_CONT, [0xAB] = CLASS_CONT,
+	[0xAC] = CLASS_CONT, [0xAD] = CLASS_CONT, [0xAE] = CLASS_CONT, [0xAF] = CLASS_CONT,
+	[0xB0] = CLASS_CONT, [0xB1] = CLASS_CONT, [0xB2] = CLASS_CONT, [0xB3] = CLASS_CONT,
+	[0xB4] = CLASS_CONT, [0xB5] = CLASS_CONT, [0xB6] = CLASS_CONT, [0xB7] = CLASS_CONT,
+	[0xB8] = CLASS_CONT, [0xB9] = CLASS_CONT, [0xBA] = CLASS_CONT, [0xBB] = CLASS_CONT,
+	[0xBC] = CLASS_CONT, [0xBD] = CLASS_CONT, [0xBE] = CLASS_CONT, [0xBF] = CLASS_CONT,
+	[0xE1] = CLASS_LEAD, [0xE2] = CLASS_LEAD, [0xE3] = CLASS_LEAD,
+};
+
+/*
+ * Is the 3-byte sequence (lead, b1, b2) one of the Unicode spaces listed
+ * above? With b2 < 0 only asks whether (lead, b1) can still become one.
+ */
+static bool utf8_space_prefix(unsigned lead, unsigned b1, int b2) {
+	switch (lead) {
+		case 0xE1: // U+1680
+			return b1 == 0x9A && (b2 < 0 || b2 == 0x80);
+		case 0xE2: // U+2000..U+2006, U+2008..U+200A, U+2028, U+2029, U+205F
+			if (b1 == 0x80) {
+				return b2 < 0 || (b2 >= 0x80 && b2 <= 0x8A && b2 != 0x87) || b2 == 0xA8 || b2 == 0xA9;
+			}
+			return b1 == 0x81 && (b2 < 0 || b2 == 0x9F);
+		case 0xE3: // U+3000
+			return b1 == 0x80 && (b2 < 0 || b2 == 0x80);
+		default:
+			return false;
+	}
+}
+
+/*
+ * The pending candidate turned out not to be a space: its lead byte began
+ * an ordinary character, which starts a word if a space preceded it.
+ */
+static void resolve_pending(struct wc_state *st) {
+	if (st->pending_len > 0) {
+		st->counts.words += st->pending_in_space;
+		st->in_space = 0;
+		st->pending = 0;
+		st->pending_len = 0;
+	}
+}
+
+/* -L bookkeeping for one byte */
+static inline void track_line_byte(struct wc_state *st, unsigned char c, unsigned cls) {
+	if (!(cls & (CLASS_CTRL | CLASS_CONT))) {
+		st->line_pos++;
+	} else if (c == '\t') {
+		st->line_pos += 8 - st->line_pos % 8;
+	} else if (c == '\n' || c == '\r' || c == '\f') {
+		if (st->line_pos > st->counts.max_line) st->counts.max_line = st->line_pos;
+		st->line_pos = 0;
+	}
+}
+
+/*
+ * Scalar table-driven kernel. Handles everything, including multibyte
+ * spaces that straddle buffer boundaries; the SIMD kernels fall back to it
+ * for their tails and for blocks they cannot classify on their own.
+ */
+static void count_scalar(struct wc_state *st, const unsigned char *buf, size_t len) {
+	size_t lines = 0;
+	size_t words = 0;
+	size_t conts = 0;
+	// Hot state lives in locals: buf is a char pointer and may alias *st
+	unsigned in_space = st->in_space;
+	bool pending = st->pending_len > 0;
+	bool track_max_line = st->track_max_line;
+
+	for (size_t i = 0; i < len; i++) {
+		unsigned char c = buf[i];
+		unsigned cls = byte_class[c];
+
+		lines += c == '\n';
+		conts += (cls & CLASS_CONT) != 0;
+		if (track_max_line) track_line_byte(st, c, cls);
+
+		// Rare path: inside or at the start of a possible multibyte space
+		if (pending || (cls & CLASS_LEAD)) {
+			st->in_space = in_space;
+			if (st->pending_len == 1 && utf8_space_prefix(st->pending, c, -1)) {
+				st->pending = (st->pending << 8) | c;
+				st->pending_len = 2;
+				continue;
+			}
+			if (st->pending_len == 2 && utf8_space_prefix(st->pending >> 8, st->pending & 0xFF, c)) {
+				st->in_space = in_space = 1;  // A complete multibyte space
+				st->pending = 0;
+				st->pending_len = 0;
+				pending = false;
+				continue;
+			}
+			resolve_pending(st);              // Not a space, so c is an ordinary byte
+			in_space = st->in_space;
+			pending = false;
+
+			if (cls & CLASS_LEAD) {
+				st->pending = c;
+				st->pending_len = 1;
+				st->pending_in_space = in_space;
+				pending = true;
+				continue;
+			}
+		}
+
+		words += in_space & !(cls & CLASS_SPACE);
+		in_space = cls & CLASS_SPACE;
+	}
+
+	st->counts.lines += lines;
+	st->counts.words += words;
+	st->counts.chars += len - conts;
+	st->in_space = in_space;
+}
+
+#ifdef HAVE_X86_KERNELS
+/* Bits [from, to) of a 64-bit mask, 0 <= from <= to <= 64 */
+static inline uint64_t bit_range(unsigned from, unsigned to) {
+	uint64_t below_to = to >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << to) - 1;
+	uint64_t below_from = from >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << from) - 1;
+	return below_to & ~below_from;
+}
+
+/*
+ * Fold the bitmasks of one 64-byte block into the counters.
+ * Blocks that may contain a multibyte space are handed to count_scalar().
+ */
+static inline void count_block(struct wc_state *st, const unsigned char *block,
+                               uint64_t newline_mask, uint64_t space_mask, uint64_t cont_mask,
+                               uint64_t ctrl_mask, uint64_t lead_mask) {
+	if (lead_mask != 0 || st->pending_len > 0) {
+		count_scalar(st, block, 64);
+		return;
+	}
+
+	uint64_t starts = ~space_mask & ((space_mask << 1) | st->in_space);
+
+	st->counts.lines += __builtin_popcountll(newline_mask);
+	st->counts.words += __builtin_popcountll(starts);
+	st->counts.chars += 64 - __builtin_popcountll(cont_mask);
+	st->in_space = (unsigned)(space_mask >> 63);
+
+	if (st->track_max_line) {
+		// Printable characters add one column each; walk the control bytes in order
+		uint64_t columns = ~(cont_mask | ctrl_mask);
+		unsigned from = 0;
+
+		while (ctrl_mask != 0) {
+			unsigned at = (unsigned)__builtin_ctzll(ctrl_mask);
+			st->line_pos += __builtin_popcountll(columns & bit_range(from, at));
+			track_line_byte(st, block[at], CLASS_CTRL);
+			from = at + 1;
+			ctrl_mask &= ctrl_mask - 1;
+		}
+		st->line_pos += __builtin_popcountll(columns & bit_range(from, 64));
+	}
+}
+
+__attribute__((target("sse2")))
+static void count_sse2(struct wc_state *st, const unsigned char *buf, size_t len) {
+	const __m128i newline = _mm_set1_epi8('\n');
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i below_tab = _mm_set1_epi8('\t' - 1);
+	const __m128i above_cr = _mm_set1_epi8('\r' + 1);
+	const __m128i first_printable = _mm_set1_epi8(0x20);
+	const __m128i del = _mm_set1_epi8(0x7F);
+	const __m128i minus_one = _mm_set1_epi8(-1);
+	const __m128i below_lead = _mm_set1_epi8((char)0xE0);
+	const __m128i above_lead = _mm_set1_epi8((char)0xE4);
+	const __m128i cont_end = _mm_set1_epi8((char)0xC0);
+	size_t i = 0;
+
+	for (; i + 64 <= len; i += 64) {
+		uint64_t newline_mask = 0, space_mask = 0, cont_mask = 0, ctrl_mask = 0, lead_mask = 0;
+
+		for (int k = 0; k < 4; k++) {
+			__m128i v = _mm_loadu_si128((const __m128i *)(buf + i + 16 * k));
+			// Signed compares: bytes >= 0x80 are negative, 0x80..0xBF is [-128, -64)
+			__m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, space),
+			                          _mm_and_si128(_mm_cmpgt_epi8(v, below_tab),
+			                                        _mm_cmplt_epi8(v, above_cr)));
+			__m128i ctrl = _mm_or_si128(_mm_and_si128(_mm_cmpgt_epi8(v, minus_one),
+			                                          _mm_cmplt_epi8(v, first_printable)),
+			                            _mm_cmpeq_epi8(v, del));
+			__m128i cont = _mm_cmplt_epi8(v, cont_end);
+			__m128i lead = _mm_and_si128(_mm_cmpgt_epi8(v, below_lead), _mm_cmplt_epi8(v, above_lead));
+			unsigned shift = 16 * (unsigned)k;
+			newline_mask |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)) << shift;
+			space_mask |= (uint64_t)(unsigned)_mm_movemask_epi8(ws) << shift;
+			cont_mask |= (uint64_t)(unsigned)_mm_movemask_epi8(cont) << shift;
+			ctrl_mask |= (uint64_t)(unsigned)_mm_movemask_epi8(ctrl) << shift;
+			lead_mask |= (uint64_t)(unsigned)_mm_movemask_epi8(lead) << shift;
+		}
+		count_block(st, buf + i, newline_mask, space_mask, cont_mask, ctrl_mask, lead_mask);
+	}
+
+	count_scalar(st, buf + i, len - i);
+}
+
+__attribute__((target("avx2,popcnt,bmi")))
+static void count_avx2(struct wc_state *st, const unsigned char *buf, size_t len) {
+	const __m256i newline = _mm256_set1_epi8('\n');
+	const __m256i space = _mm256_set1_epi8(' ');
+	const __m256i below_tab = _mm256_set1_epi8('\t' - 1);
+	const __m256i above_cr = _mm256_set1_epi8('\r' + 1);
+	const __m256i first_printable = _mm256_set1_epi8(0x20);
+	const __m256i del = _mm256_set1_epi8(0x7F);
+	const __m256i minus_one = _mm256_set1_epi8(-1);
+	const __m256i below_lead = _mm256_set1_epi8((char)0xE0);
+	const __m256i above_lead = _mm256_set1_epi8((char)0xE4);
+	const __m256i cont_end = _mm256_set1_epi8((char)0xC0);
+	size_t i = 0;
+
+	for (; i + 64 <= len; i += 64) {
+		uint64_t newline_mask = 0, space_mask = 0, cont_mask = 0, ctrl_mask = 0, lead_mask = 0;
+
+		for (int k = 0; k < 2; k++) {
+			__m256i v = _mm256_loadu_si256((const __m256i *)(buf + i + 32 * k));
+			__m256i ws = _mm256_or_si256(_mm256_cmpeq_epi8(v, space),
+			                             _mm256_and_si256(_mm256_cmpgt_epi8(v, below_tab),
+			                                              _mm256_cmpgt_epi8(above_cr, v)));
+			__m256i ctrl = _mm256_or_si256(_mm256_and_si256(_mm256_cmpgt_epi8(v, minus_one),
+			                                                _mm256_cmpgt_epi8(first_printable, v)),
+			                               _mm256_cmpeq_epi8(v, del));
+			__m256i cont = _mm256_cmpgt_epi8(cont_end, v);
+			__m256i lead = _mm256_and_si256(_mm256_cmpgt_epi8(v, below_lead),
+			                                _mm256_cmpgt_epi8(above_lead, v));
+			unsigned shift = 32 * (unsigned)k;
+			newline_mask |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline)) << shift;
+			space_mask |= (uint64_t)(uint32_t)_mm256_movemask_epi8(ws) << shift;
+			cont_mask |= (uint64_t)(uint32_t)_mm256_movemask_epi8(cont) << shift;
+			ctrl_mask |= (uint64_t)(uint32_t)_mm256_movemask_epi8(ctrl) << shift;
+			lead_mask |= (uint64_t)(uint32_t)_mm256_movemask_epi8(lead) << shift;
+		}
+		count_block(st, buf + i, newline_mask, space_mask, cont_mask, ctrl_mask, lead_mask);
+	}
+
+	count_scalar(st, buf + i, len - i);
+}
+
+__attribute__((target("avx512bw,popcnt,bmi")))
+static void count_avx512(struct wc_state *st, const unsigned char *buf, size_t len) {
+	const __m512i newline = _mm512_set1_epi8('\n');
+	const __m512i space = _mm512_set1_epi8(' ');
+	const __m512i tab = _mm512_set1_epi8('\t');
+	const __m512i ctrl_span = _mm512_set1_epi8('\r' - '\t');
+	const __m512i first_printable = _mm512_set1_epi8(0x20);
+	const __m512i del = _mm512_set1_epi8(0x7F);
+	const __m512i top_bits = _mm512_set1_epi8((char)0xC0);
+	const __m512i cont_bits = _mm512_set1_epi8((char)0x80);
+	const __m512i lead_first = _mm512_set1_epi8((char)0xE1);
+	const __m512i lead_span = _mm512_set1_epi8(0xE3 - 0xE1);
+	size_t i = 0;
+
+	for (; i + 64 <= len; i += 64) {
+		__m512i v = _mm512_loadu_si512((const void *)(buf + i));
+		// Unsigned (byte - first) <= span selects a contiguous range in one compare
+		uint64_t space_mask = _mm512_cmpeq_epi8_mask(v, space) |
+		                      _mm512_cmple_epu8_mask(_mm512_sub_epi8(v, tab), ctrl_span);
+		uint64_t newline_mask = _mm512_cmpeq_epi8_mask(v, newline);
+		uint64_t cont_mask = _mm512_cmpeq_epi8_mask(_mm512_and_si512(v, top_bits), cont_bits);
+		uint64_t ctrl_mask = _mm512_cmplt_epu8_mask(v, first_printable) | _mm512_cmpeq_epi8_mask(v, del);
+		uint64_t lead_mask = _mm512_cmple_epu8_mask(_mm512_sub_epi8(v, lead_first), lead_span);
+		count_block(st, buf + i, newline_mask, space_mask, cont_mask, ctrl_mask, lead_mask);
+	}
+
+	count_scalar(st, buf + i, len - i);
+}
+#endif /* HAVE_X86_KERNELS */
+
+static const struct {
+	const char *name;
+	count_kernel_fn fn;
+} count_kernels[] = {
+	{"scalar", count_scalar},
+#ifdef HAVE_X86_KERNELS
+	{"sse2", count_sse2},
+	{"avx2", count_avx2},
+	{"avx512", count_avx512},
+#endif
+};
+
+static size_t kernel_index = 0;
+static bool kernel_selected = false;
+
+/*
+ * Pick a kernel. The best one is the fastest this CPU supports (cpuid via
+ * __builtin_cpu_supports, which also checks that the OS saves the wider
+ * registers); a named kernel is used only if it is not better than that.
+ */
+const char *wc_select_kernel(const char *name) {
+	size_t best = 0;
+
+#ifdef HAVE_X86_KERNELS
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512bw")) {
+		best = 3;
+	} else if (__builtin_cpu_supports("avx2")) {
+		best = 2;
+	} else if (__builtin_cpu_supports("sse2")) {
+		best = 1;
+	}
+#endif
+
+	kernel_index = best;
+	if (name != NULL) {
+		for (size_t k = 0; k <= best; k++) {
+			if (strcmp(name, count_kernels[k].name) == 0) {
+				kernel_index = k;
+				break;
+			}
+		}
+	}
+
+	kernel_selected = true;
+	return count_kernels[kernel_index].name;
+}
+
+const char *wc_kernel_name(void) {
+	return count_kernels[kernel_index].name;
+}
+
+
+// Streaming API
+void wc_init(struct wc_state *st, unsigned flags) {
+	assert(st != NULL);
+
+	if (!kernel_selected) {
+		wc_select_kernel(NULL);
+	}
+
+	memset(st, 0, sizeof(*st));
+	st->in_space = 1;
+	st->track_max_line = (flags & WC_MAX_LINE) != 0;
+}
+
+void wc_feed(struct wc_state *st, const void *buf, size_t len) {
+	assert(st != NULL);
+	const unsigned char *bytes = buf;
+
+	if (len == 0) return;
+
+	if (st->counts.bytes == 0) {
+		st->starts_in_word = !((byte_class[bytes[0]] & CLASS_SPACE) ||
+		                       (len >= 3 && utf8_space_prefix(bytes[0], bytes[1], bytes[2])));
+	}
+
+	count_kernels[kernel_index].fn(st, bytes, len);
+	st->counts.bytes += len;
+	st->last_char = bytes[len - 1];
+}
+
+struct wc_counts wc_finish(const struct wc_state *st) {
+	assert(st != NULL);
+	struct wc_state end = *st;
+
+	resolve_pending(&end);  // A lead byte at end of input was not a space
+
+	struct wc_counts counts = end.counts;
+
+	// Count last line if the stream doesn't end with newline (POSIX wc behavior)
+	if ((counts.bytes > 0) && (end.last_char != '\n')) {
+		counts.lines++;
+	}
+
+	if (end.line_pos > counts.max_line) {
+		counts.max_line = end.line_pos;
+	}
+
+	return counts;
+}
+
+
+// Parallel counting
+/*
+ * Both states counted their part as a stream of its own. A word straddling
+ * the cut was counted on both sides exactly when left ends inside a word
+ * and right starts inside one, so one word is taken back:
+ *
+ *   words(L + R) = words(L) + words(R) - (L ends in word && R starts in word)
+ *
+ * Lines, characters and bytes simply add up. The cut must be on a character
+ * boundary so no multibyte space is split; -L widths are not mergeable.
+ */
+void wc_merge(struct wc_state *left, const struct wc_state *right) {
+	assert(left != NULL);
+	assert(right != NULL);
+	assert(!left->track_max_line && !right->track_max_line);
+
+	if (right->counts.bytes == 0) return;
+
+	if (left->counts.bytes == 0) {
+		*left = *right;
+		return;
+	}
+
+	resolve_pending(left);   // Right begins on a character boundary: not a space
+
+	bool split_word = !left->in_space && right->starts_in_word;
+
+	left->counts.lines += right->counts.lines;
+	left->counts.words += right->counts.words - (split_word ? 1u : 0u);
+	left->counts.chars += right->counts.chars;
+	left->counts.bytes += right->counts.bytes;
+	left->in_space = right->in_space;
+	left->last_char = right->last_char;
+
+	// An undecided sequence at the end of right stays open, as in a serial count
+	left->pending = right->pending;
+	left->pending_len = right->pending_len;
+	left->pending_in_space = right->pending_in_space;
+}
+
+
+// Saving state
+/*
+ * Text form: a version tag followed by every field as a decimal number.
+ * Restoring it and feeding more bytes gives the same counts as if the
+ * stream had never been interrupted.
+ */
+int wc_state_format(const struct wc_state *st, char *buf, size_t size) {
+	assert(st != NULL);
+
+	return snprintf(buf, size, "wc1 %ju %ju %ju %ju %ju %u %d %d %d %ju %u %u %u",
+	                st->counts.lines, st->counts.words, st->counts.chars,
+	                st->counts.bytes, st->counts.max_line,
+	                st->in_space, st->last_char, (int)st->track_max_line,
+	                (int)st->starts_in_word, st->line_pos,
+	                st->pending, st->pending_len, st->pending_in_space);
+}
+
+bool wc_state_parse(struct wc_state *st, const char *text) {
+	assert(st != NULL);
+	assert(text != NULL);
+
+	struct wc_state parsed;
+	int track, starts;
+	int consumed = 0;
+
+	memset(&parsed, 0, sizeof(parsed));
+	int fields = sscanf(text, "wc1 %ju %ju %ju %ju %ju %u %d %d %d %ju %u %u %u%n",
+	                    &parsed.counts.lines, &parsed.counts.words, &parsed.counts.chars,
+	                    &parsed.counts.bytes, &parsed.counts.max_line,
+	                    &parsed.in_space, &parsed.last_char, &track, &starts,
+	                    &parsed.line_pos, &parsed.pending, &parsed.pending_len,
+	                    &parsed.pending_in_space, &consumed);
+
+	// Reject anything a real stream could not have produced
+	if (fields != 13 || consumed == 0 ||
+	    parsed.in_space > 1 || parsed.pending_in_space > 1 || parsed.pending_len > 2 ||
+	    parsed.last_char < 0 || parsed.last_char > 255 || parsed.pending > 0xFFFF ||
+	    (track != 0 && track != 1) || (starts != 0 && starts != 1)) {
+		return false;
+	}
+
+	parsed.track_max_line = track;
+	parsed.starts_in_word = starts;
+	*st = parsed;
+	return true;
+}
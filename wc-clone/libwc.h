@@ -0,0 +1,75 @@
+#ifndef LIBWC_H
+#define LIBWC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * libwc - Incremental line, word, character and byte counting
+ *
+ * The counting engine behind my_wc, usable on data that arrives in pieces
+ * (network buffers, log shipper batches, ...):
+ *
+ *   struct wc_state st;
+ *   wc_init(&st, 0);
+ *   while ((n = read(fd, buf, sizeof buf)) > 0)
+ *       wc_feed(&st, buf, n);
+ *   struct wc_counts c = wc_finish(&st);
+ *
+ * Features:
+ * - Word state is carried across wc_feed() calls: splitting the input at
+ *   any byte, even inside a UTF-8 sequence, gives the same counts
+ * - No allocation: struct wc_state is plain data and may live on the stack
+ * - SIMD kernels (SSE2/AVX2/AVX-512) chosen at runtime, scalar fallback
+ * - Input is treated as UTF-8 for characters, words and line width
+ */
+
+/* Counts of everything fed so far */
+struct wc_counts {
+	uintmax_t lines;     // Newlines, plus one for an unterminated last line
+	uintmax_t words;     // Runs of non-whitespace characters
+	uintmax_t chars;     // UTF-8 characters (bytes that are not 10xxxxxx)
+	uintmax_t bytes;
+	uintmax_t max_line;  // Widest line in columns (only with WC_MAX_LINE)
+};
+
+/* wc_init() flags */
+enum {
+	WC_MAX_LINE = 1,     // Track the maximum line length (costs extra work per line)
+};
+
+/*
+ * Streaming state. Fields are private to libwc; the struct is public only
+ * so callers can embed it without allocating.
+ */
+struct wc_state {
+	struct wc_counts counts;
+	unsigned in_space;          // 1 if the previous character was whitespace (or start of stream)
+	int last_char;
+	bool track_max_line;
+	bool starts_in_word;        // First character fed was not whitespace (for wc_merge)
+	uintmax_t line_pos;         // Display column within the current line
+	unsigned pending;           // Bytes of an undecided multibyte space candidate, packed
+	unsigned pending_len;
+	unsigned pending_in_space;  // in_space before the candidate's lead byte
+};
+
+// Streaming API
+void wc_init(struct wc_state *st, unsigned flags);                 // Start a new stream (flags: WC_MAX_LINE)
+void wc_feed(struct wc_state *st, const void *buf, size_t len);    // Count the next len bytes of the stream
+struct wc_counts wc_finish(const struct wc_state *st);             // Counts as if the stream ended here (state is unchanged, feeding may continue)
+
+// Parallel counting
+void wc_merge(struct wc_state *left, const struct wc_state *right);// Append a stream counted separately; the cut must be on a UTF-8 character boundary, no WC_MAX_LINE
+
+// Saving state (e.g. to resume counting an append-only file later)
+#define WC_STATE_TEXT_MAX 256                                      // Buffer size that always fits wc_state_format()
+int wc_state_format(const struct wc_state *st, char *buf, size_t size);// Write state as one line of text (snprintf semantics)
+bool wc_state_parse(struct wc_state *st, const char *text);        // Restore state from wc_state_format() text, false if malformed
+
+// Kernel selection
+const char *wc_select_kernel(const char *name);                    // Use kernel name (or the best one for NULL/unknown); returns the chosen name. Call once before threads start
+const char *wc_kernel_name(void);                                  // Name of the kernel in use
+
+#endif /* LIBWC_H */
@@ -1,26 +1,52 @@
+#define _POSIX_C_SOURCE 200809L // for fileno(), pread(), pthreads, sigaction() and clock_gettime()
 #include <stdio.h>
 #include <stdlib.h>
-#include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#include "libwc.h"
+#include "wc_cache.h"
+
+#define READ_BUFFER_SIZE (128 * 1024)
+#define MAX_JOBS 256
+#define MIN_CHUNK_SIZE (1024 * 1024)  // Smaller files are not worth a thread
+#define MAX_INTERVAL 86400.0          // --interval upper bound in seconds
+#define PREFETCH_DEPTH 16             // Files opened ahead of the one being counted
+#define PREFETCH_BYTES (1024 * 1024)  // Readahead requested for each of them
 
 /* Configuration flags */
 struct config {
 	bool show_lines;
 	bool show_words;
-	bool show_chars;
-};
-
-struct file_stats {
-	int lines;
-	int words;
-	int chars;
+	bool show_chars;    // -m: UTF-8 characters
+	bool show_bytes;    // -c
+	bool show_max_line; // -L
+	int jobs;           // -j N: threads used to count one large file
+	int width;          // Column width, fixed by compute_number_width() before counting
+	wc_cache *cache;    // --cache=FILE: resume append-only files, NULL if not used
+	bool follow;        // --follow: keep reporting counts as the file grows
+	double interval;    // --interval=SECS: seconds between --follow reports
+	const char *files0_from;  // --files0-from=F: NUL-separated names from F ("-" is stdin), or NULL
 };
 
 /* Function prototypes */
-int parse_args(int argc, const char* argv[], struct config *cfg);
-struct file_stats count_stream(FILE *fp);
-void print_stats(const struct file_stats *stats, const struct config *cfg);
+int parse_args(int argc, const char* argv[], struct config *cfg, const char **cache_path);
+struct wc_counts count_stream(FILE *fp, const struct config *cfg);
+struct wc_counts count_file(FILE *fp, const struct config *cfg);
+int compute_number_width(const char *const names[], int count, const struct config *cfg);
+void print_stats(const struct wc_counts *stats, const struct config *cfg);
 void print_help(const char *prog_name);
 void print_version(void);
 
@@ -29,17 +55,34 @@ void print_version(void);
  */
 void print_help(const char *prog_name) {
     printf("Usage: %s [OPTION]... [FILE]...\n", prog_name);
-    printf("Print newline, word, and byte counts for each FILE.\n\n");
+    printf("  or:  %s [OPTION]... --files0-from=F\n", prog_name);
+    printf("Print newline, word, and byte counts for each FILE.\n");
+    printf("Input is treated as UTF-8 for -m, -L and word boundaries.\n\n");
     printf("With no FILE read standard input.\n\n");
     printf("Options:\n");
     printf("  -l, --lines            print the line count\n");
     printf("  -w, --words            print the word count\n");
     printf("  -c, --bytes            print the byte count\n");
+    printf("  -m, --chars            print the UTF-8 character count\n");
+    printf("  -L, --max-line-length  print the maximum display width\n");
+    printf("  -j, --jobs=N           use N threads: split one large regular file,\n");
+    printf("                           or count several FILEs concurrently\n");
+    printf("      --files0-from=F    read input from the files named by NUL-terminated\n");
+    printf("                           names in file F; if F is - read names from stdin\n");
+    printf("      --cache=FILE       remember counts in FILE; on later runs only read\n");
+    printf("                           what was appended to each FILE since\n");
+    printf("      --follow           keep counting FILE as it grows, printing running\n");
+    printf("                           counts until interrupted\n");
+    printf("      --interval=SECS    seconds between --follow reports (default 1)\n");
     printf("      --help             display this help and exit\n");
     printf("      --version          output version information and exit\n\n");
     printf("Examples:\n");
     printf("  %s file.txt            # Count lines, words, bytes\n", prog_name);
     printf("  %s -l file.txt         # Count lines only\n", prog_name);
+    printf("  %s -j 8 huge.log       # Split one big file across 8 threads\n", prog_name);
+    printf("  %s --cache=.wc app.log # Re-count a growing log, reading only new lines\n", prog_name);
+    printf("  %s --follow -l app.log # Watch a log's line count grow\n", prog_name);
+    printf("  find . -name '*.c' -print0 | %s --files0-from=-  # Count a long file list\n", prog_name);
     printf("  cat file.txt | %s      # Count from stdin\n", prog_name);
 }
 
@@ -49,21 +92,71 @@ void print_help(const char *prog_name) {
 void print_version(void) {
     printf("my_wc 1.0\n");
     printf("A wc (word count) implementation for learning C.\n");
-    printf("Features: -l, -w, -c flags, multiple files, stdin support.\n");
+    printf("Features: -l, -w, -c, -m, -L flags, multiple files, stdin support.\n");
+    printf("Counting kernel is chosen at startup (set MY_WC_KERNEL to override).\n");
+}
+
+/*
+ * Parse the argument of -j/--jobs, exiting on anything that is not 1..MAX_JOBS.
+ */
+static int parse_jobs(const char *prog_name, const char *value) {
+	char *end;
+	long jobs;
+
+	if (value == NULL) {
+		fprintf(stderr, "%s: option requires an argument -- 'j'\n", prog_name);
+		fprintf(stderr, "Try '%s --help' for more information.\n", prog_name);
+		exit(EXIT_FAILURE);
+	}
+
+	errno = 0;
+	jobs = strtol(value, &end, 10);
+	if (errno != 0 || end == value || *end != '\0' || jobs < 1 || jobs > MAX_JOBS) {
+		fprintf(stderr, "%s: invalid number of jobs: '%s' (expected 1..%d)\n", prog_name, value, MAX_JOBS);
+		exit(EXIT_FAILURE);
+	}
+
+	return (int)jobs;
+}
+
+/*
+ * Parse the argument of --interval, exiting on anything that is not a
+ * positive number of seconds up to MAX_INTERVAL.
+ */
+static double parse_interval(const char *prog_name, const char *value) {
+	char *end;
+	double seconds;
+
+	errno = 0;
+	seconds = strtod(value, &end);
+	if (errno != 0 || end == value || *end != '\0' || !(seconds > 0) || seconds > MAX_INTERVAL) {
+		fprintf(stderr, "%s: invalid interval: '%s'\n", prog_name, value);
+		exit(EXIT_FAILURE);
+	}
+
+	return seconds;
 }
 
 /*
  * Parse command-line arguments.
  * Returns index of first non-option argument (first filename).
- * Sets flags in config struct.
+ * Sets flags in config struct; *cache_path is the --cache file or NULL.
  */
-int parse_args(int argc, const char* argv[], struct config *cfg) {
+int parse_args(int argc, const char* argv[], struct config *cfg, const char **cache_path) {
 	int i = 1;
 
 	// Initialize all to false
 	cfg->show_chars = false;
+	cfg->show_bytes = false;
+	cfg->show_max_line = false;
 	cfg->show_words = false;
 	cfg->show_lines = false;
+	cfg->jobs = 1;
+	cfg->cache = NULL;
+	cfg->follow = false;
+	cfg->interval = 1.0;
+	cfg->files0_from = NULL;
+	*cache_path = NULL;
 
 	// Parse options
 	while (i < argc && argv[i][0] == '-') {
@@ -74,7 +167,21 @@ int parse_args(int argc, const char* argv[], struct config *cfg) {
             } else if (strcmp(argv[i], "--words") == 0) {
                 cfg->show_words = true;
             } else if (strcmp(argv[i], "--bytes") == 0) {
+                cfg->show_bytes = true;
+            } else if (strcmp(argv[i], "--chars") == 0) {
                 cfg->show_chars = true;
+            } else if (strcmp(argv[i], "--max-line-length") == 0) {
+                cfg->show_max_line = true;
+            } else if (strncmp(argv[i], "--jobs=", 7) == 0) {
+                cfg->jobs = parse_jobs(argv[0], argv[i] + 7);
+            } else if (strncmp(argv[i], "--cache=", 8) == 0 && argv[i][8] != '\0') {
+                *cache_path = argv[i] + 8;
+            } else if (strncmp(argv[i], "--files0-from=", 14) == 0 && argv[i][14] != '\0') {
+                cfg->files0_from = argv[i] + 14;
+            } else if (strcmp(argv[i], "--follow") == 0) {
+                cfg->follow = true;
+            } else if (strncmp(argv[i], "--interval=", 11) == 0) {
+                cfg->interval = parse_interval(argv[0], argv[i] + 11);
             } else if (strcmp(argv[i], "--help") == 0) {
                 print_help(argv[0]);
                 exit(EXIT_SUCCESS);
@@ -98,10 +205,19 @@ int parse_args(int argc, const char* argv[], struct config *cfg) {
 			}
 	
 			for (int j = 0; opt[j] != '\0'; j++) {
+				// -jN or -j N: the rest of the argument (or the next one) is the value
+				if (opt[j] == 'j') {
+					const char *value = opt[j + 1] != '\0' ? &opt[j + 1] : (i + 1 < argc ? argv[++i] : NULL);
+					cfg->jobs = parse_jobs(argv[0], value);
+					break;
+				}
+
 				switch (opt[j]) {
 					case 'l': cfg->show_lines = true; break;
 					case 'w': cfg->show_words = true; break;
-					case 'c': cfg->show_chars = true; break;
+					case 'c': cfg->show_bytes = true; break;
+					case 'm': cfg->show_chars = true; break;
+					case 'L': cfg->show_max_line = true; break;
 					default:
 						fprintf(stderr, "%s: invalid option -- '%c'\n", argv[0], opt[j]);
 		                fprintf(stderr, "Try '%s --help' for more information.\n", argv[0]);
@@ -116,132 +232,816 @@ int parse_args(int argc, const char* argv[], struct config *cfg) {
 	}
 
 	// If no flags specified, show everything (default behavior)
-	if (!cfg->show_lines && !cfg->show_words && !cfg->show_chars) {
-				cfg->show_lines = cfg->show_words = cfg->show_chars = true;
+	if (!cfg->show_lines && !cfg->show_words && !cfg->show_chars && !cfg->show_bytes && !cfg->show_max_line) {
+				cfg->show_lines = cfg->show_words = cfg->show_bytes = true;
 	}
 	
 	return i;  // Return index of first filename
 }
 
+/* Feed everything left in fp to st */
+static void feed_stream(FILE *fp, struct wc_state *st) {
+	unsigned char buf[READ_BUFFER_SIZE];
+	size_t n;
+
+	while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+		wc_feed(st, buf, n);
+	}
+}
+
 /*
- * count_stream - Count characters, words, and lines in a FILE stream
+ * count_stream - Count lines, words, characters and bytes in a FILE stream
  * 
  * Arguments:
- *   fp - FILE pointer open for reading (must be opened with "r")
+ *   fp  - FILE pointer open for reading (must be opened with "r")
+ *   cfg - only cfg->show_max_line matters: whether to track -L
  * 
  * Returns:
- *   file_stats struct with character, word, and line counts
+ *   wc_counts struct with line, word, character and byte counts
+ *   (and the maximum line length if requested)
  * 
  * Design decisions:
- *   - Uses fgetc() for clarity over performance
- *   - State machine word counting algorithm
- *   - POSIX-compliant line counting
+ *   - Reads READ_BUFFER_SIZE blocks with fread() instead of fgetc()
+ *   - Counting itself is libwc's streaming API (see libwc.h)
  * 
  * Note: Caller is responsible for closing fp.
  */
-struct file_stats count_stream(FILE *fp) {
-    struct file_stats stats = {0, 0, 0};
-    bool looking_for_word_start = true; // Start in "looking for word" state
-    int ch;
-	int last_char = 0;
-    
-	while ((ch = fgetc(fp)) != EOF) {
-		stats.chars++;
-		last_char = ch;
+struct wc_counts count_stream(FILE *fp, const struct config *cfg) {
+	struct wc_state st;
+
+	wc_init(&st, cfg->show_max_line ? WC_MAX_LINE : 0);
+	feed_stream(fp, &st);
+
+	return wc_finish(&st);
+}
+
+/*
+ * Parallel counting of one regular file
+ *
+ * The byte range is cut into one chunk per thread and each chunk is fed to
+ * its own wc_state. wc_merge() then joins the chunks in file order,
+ * correcting for words that straddle a cut, so the totals equal the serial
+ * counts. Cuts are moved forward past UTF-8 continuation bytes so that no
+ * character is split between two chunks. -L is not mergeable this way (a
+ * tab's width depends on the column it starts at) and is counted serially.
+ */
+struct chunk_job {
+	int fd;
+	off_t offset;
+	off_t length;
+	struct wc_state st;
+};
+
+/* Move a cut forward past continuation bytes so it lands on a character start */
+static off_t align_cut(int fd, off_t cut, off_t end) {
+	unsigned char peek[4];
+	ssize_t n = pread(fd, peek, sizeof(peek), cut);
+
+	for (ssize_t k = 0; k < n && (peek[k] & 0xC0) == 0x80; k++) {
+		cut++;
+	}
+
+	return cut < end ? cut : end;
+}
+
+/*
+ * Feed st the continuation bytes at start, if any. A state resumed from the
+ * cache may end inside a character (even inside a multibyte space); chunks
+ * can only be merged into it from the next character boundary, which is
+ * returned.
+ */
+static off_t feed_to_boundary(int fd, off_t start, off_t end, struct wc_state *st) {
+	unsigned char buf[4];
+	off_t aligned = align_cut(fd, start, end);
+	size_t len = (size_t)(aligned - start);
+
+	if (len == 0) return start;
+	if (pread(fd, buf, len, start) != (ssize_t)len) return start;
+
+	wc_feed(st, buf, len);
+	return aligned;
+}
+
+/* Thread entry point: count job->length bytes at job->offset with pread() */
+static void *count_chunk(void *arg) {
+	struct chunk_job *job = arg;
+	unsigned char buf[READ_BUFFER_SIZE];
+	off_t done = 0;
+
+	wc_init(&job->st, 0);
+
+	while (done < job->length) {
+		off_t left = job->length - done;
+		size_t want = left < (off_t)sizeof(buf) ? (size_t)left : sizeof(buf);
+		ssize_t n = pread(job->fd, buf, want, job->offset + done);
+
+		if (n < 0 && errno == EINTR) continue;
+		if (n <= 0) break;  // Read error or file shrank: count what we have, like fread()
+
+		wc_feed(&job->st, buf, (size_t)n);
+		done += n;
+	}
+
+	return NULL;
+}
+
+/*
+ * Count bytes [start, end) of fd with up to jobs threads and merge them
+ * into total (fresh from wc_init(), or resumed from the cache; no -L).
+ * start must be on a character boundary, see feed_to_boundary().
+ * If a thread cannot be started its chunk is counted on the calling thread.
+ */
+static void count_parallel(int fd, off_t start, off_t end, int jobs, struct wc_state *total) {
+	struct chunk_job chunks[MAX_JOBS];
+	pthread_t threads[MAX_JOBS];
+	bool started[MAX_JOBS];
+	off_t size = end - start;
+	int nchunks = jobs;
+
+	if (size / MIN_CHUNK_SIZE < nchunks) {
+		nchunks = (int)(size / MIN_CHUNK_SIZE);
+	}
+	if (nchunks < 1) nchunks = 1;
+
+	off_t chunk_size = size / nchunks;
+	for (int c = 0; c < nchunks; c++) {
+		chunks[c].fd = fd;
+		chunks[c].offset = c == 0 ? start : align_cut(fd, start + c * chunk_size, end);
+	}
+	for (int c = 0; c < nchunks; c++) {
+		chunks[c].length = (c == nchunks - 1 ? end : chunks[c + 1].offset) - chunks[c].offset;
+		started[c] = c > 0 && pthread_create(&threads[c], NULL, count_chunk, &chunks[c]) == 0;
+	}
+
+	// The calling thread takes chunk 0 plus any chunk whose thread failed to start
+	for (int c = 0; c < nchunks; c++) {
+		if (!started[c]) count_chunk(&chunks[c]);
+	}
+
+	for (int c = 0; c < nchunks; c++) {
+		if (started[c]) pthread_join(threads[c], NULL);
+		wc_merge(total, &chunks[c].st);
+	}
+}
+
+/*
+ * Count an open file.
+ *
+ * Fast paths for regular files, chosen from one fstat():
+ *   - Only -c requested: the byte count is st_size minus the current offset,
+ *     nothing is read. Empty-looking files (st_size 0, e.g. in /proc) are
+ *     still read, since their real size is only known by reading them.
+ *   - With --cache, a file read from its start resumes from the state cached
+ *     by an earlier run if it has only grown since, and the new state is
+ *     stored for the next run.
+ *   - With -j N (and no -L), a remainder of at least two chunks is split
+ *     across threads.
+ * Pipes, terminals, devices and small files use count_stream().
+ */
+struct wc_counts count_file(FILE *fp, const struct config *cfg) {
+	bool bytes_only = cfg->show_bytes && !cfg->show_lines && !cfg->show_words &&
+	                  !cfg->show_chars && !cfg->show_max_line;
+	bool split = cfg->jobs > 1 && !cfg->show_max_line;
+	bool cacheable = cfg->cache != NULL && !bytes_only;
+	unsigned flags = cfg->show_max_line ? WC_MAX_LINE : 0;
+	int fd = fileno(fp);
+	struct stat st;
+
+	if ((bytes_only || split || cacheable) && fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+		// Honour the current offset (e.g. stdin redirected from a partly read file)
+		off_t start = lseek(fd, 0, SEEK_CUR);
+
+		if (start >= 0 && bytes_only && st.st_size > 0) {
+			struct wc_counts stats = {0, 0, 0, 0, 0};
+			if (start < st.st_size) {
+				stats.bytes = (uintmax_t)(st.st_size - start);
+				lseek(fd, st.st_size, SEEK_SET);  // Leave the offset where a serial read would
+			}
+			return stats;
+		}
+
+		cacheable = cacheable && start == 0;  // Cached states describe whole files
+
+		if (start >= 0 && (split || cacheable)) {
+			struct wc_state state;
 
-		if (ch == '\n') {
-			stats.lines++;
+			if (cacheable && wc_cache_lookup(cfg->cache, &st, fd, flags, &state)) {
+				start = (off_t)state.counts.bytes;
+			} else {
+				wc_init(&state, flags);
+			}
+
+			// A resumed state may track -L even when it is not shown: keep that serial
+			if (split && !state.track_max_line && st.st_size - start >= 2 * (off_t)MIN_CHUNK_SIZE) {
+				start = feed_to_boundary(fd, start, st.st_size, &state);
+				count_parallel(fd, start, st.st_size, cfg->jobs, &state);
+				lseek(fd, st.st_size, SEEK_SET);
+			} else if (fseeko(fp, start, SEEK_SET) == 0) {
+				feed_stream(fp, &state);
+			}
+
+			if (cacheable) {
+				wc_cache_store(cfg->cache, &st, fd, &state);
+			}
+			return wc_finish(&state);
 		}
+	}
+
+	return count_stream(fp, cfg);
+}
 
-		if (isspace(ch)) {
-			looking_for_word_start = true; // Next non-space starts new word
-		} else if (looking_for_word_start) {
-			// Found first letter of a word
-			stats.words++;
-			looking_for_word_start = false; // Now inside a word, stop looking
+/*
+ * Batched file lists (--files0-from)
+ *
+ * Reads the whole NUL-separated list into one buffer and returns the number
+ * of names, with *names pointing into *storage (free both). Empty names are
+ * reported and skipped, and so is "-" in a list read from standard input,
+ * as GNU wc does. Elsewhere "-" names a file called "-", like a FILE
+ * argument. Exits if the list cannot be read at all.
+ */
+static int read_files0(const char *prog_name, const char *path, char **storage, const char ***names) {
+	bool from_stdin = strcmp(path, "-") == 0;
+	FILE *fp = from_stdin ? stdin : fopen(path, "r");
+	size_t len = 0, capacity = 64 * 1024;
+	char *buf = malloc(capacity);
+	size_t n;
+
+	if (fp == NULL) {
+		fprintf(stderr, "%s: cannot open '%s' for reading\n", prog_name, path);
+		exit(EXIT_FAILURE);
+	}
+
+	while (buf != NULL && (n = fread(buf + len, 1, capacity - len - 1, fp)) > 0) {
+		len += n;
+		if (capacity - len - 1 == 0) {
+			char *grown = realloc(buf, capacity * 2);
+			if (grown == NULL) free(buf);
+			buf = grown;
+			capacity *= 2;
 		}
-		// If we're inside a word and see non-whitespace: do nothing
+	}
+	if (buf == NULL || ferror(fp)) {
+		fprintf(stderr, "%s: cannot read file names from '%s'\n", prog_name, path);
+		exit(EXIT_FAILURE);
+	}
+	if (!from_stdin) fclose(fp);
+	buf[len] = '\0';  // Terminates a last name that has no NUL of its own
 
+	// Count the names to size the array in one go
+	size_t count = 0;
+	for (size_t i = 0; i < len; i++) {
+		count += buf[i] == '\0';
 	}
+	if (len > 0 && buf[len - 1] != '\0') count++;
 
-	// Count last line if file doesn't end with newline (POSIX wc behavior)
-	if ((stats.chars > 0) && (last_char != '\n')) {
-		stats.lines++;
+	const char **list = calloc(count > 0 ? count : 1, sizeof(*list));
+	if (list == NULL) {
+		fprintf(stderr, "%s: cannot read file names from '%s'\n", prog_name, path);
+		exit(EXIT_FAILURE);
 	}
 
-	return stats;
+	int found = 0;
+	size_t item = 0;
+	for (size_t start = 0; start < len; item++) {
+		size_t end = start + strlen(buf + start);
+		if (end == start) {
+			fprintf(stderr, "%s: %s:%zu: invalid zero-length file name\n", prog_name, path, item + 1);
+		} else if (from_stdin && strcmp(buf + start, "-") == 0) {
+			fprintf(stderr, "%s: %s:%zu: when reading file names from standard input, no file name of '-' allowed\n",
+			        prog_name, path, item + 1);
+		} else {
+			list[found++] = buf + start;
+		}
+		start = end + 1;
+	}
+
+	*storage = buf;
+	*names = list;
+	return found;
+}
+
+/*
+ * Readahead for the serial file loop
+ *
+ * The next PREFETCH_DEPTH files are opened before they are counted, and
+ * posix_fadvise(WILLNEED) asks the kernel to start reading their first
+ * PREFETCH_BYTES in the background. Only that readahead is asynchronous:
+ * the opens themselves still run on the counting thread, just earlier. The
+ * disk reads of upcoming files then overlap counting the current one, which
+ * is what dominates long lists of small files. With only -c nothing is
+ * read, so nothing is advised.
+ *
+ * Only regular files are opened ahead. Opening a FIFO blocks until it has
+ * a writer, which would hold up the files listed before it, so FIFOs,
+ * devices and names that cannot be stat()ed are opened when reached.
+ */
+#define PREFETCH_DEFERRED (-2)  // fds[] entry: open when reached
+struct prefetch {
+	const char *const *names;
+	int count;
+	int next;                   // Next name to open
+	bool advise;
+	int fds[PREFETCH_DEPTH];    // fds[i % PREFETCH_DEPTH] for names [current, next), -1 if open failed or PREFETCH_DEFERRED
+};
+
+static void prefetch_init(struct prefetch *pf, const char *const names[], int count, const struct config *cfg) {
+	pf->names = names;
+	pf->count = count;
+	pf->next = 0;
+	pf->advise = !(cfg->show_bytes && !cfg->show_lines && !cfg->show_words &&
+	               !cfg->show_chars && !cfg->show_max_line);
+}
+
+/*
+ * Open names[index], opening and advising the regular files after it first
+ * if they are not yet; NULL if it cannot be opened. The opens are
+ * synchronous.
+ */
+static FILE *prefetch_take(struct prefetch *pf, int index) {
+	while (pf->next < pf->count && pf->next < index + PREFETCH_DEPTH) {
+		const char *name = pf->names[pf->next];
+		struct stat sb;
+		int fd = PREFETCH_DEFERRED;
+
+		if (fstatat(AT_FDCWD, name, &sb, 0) == 0 && S_ISREG(sb.st_mode)) {
+			fd = openat(AT_FDCWD, name, O_RDONLY | O_CLOEXEC);
+			if (fd >= 0 && pf->advise) {
+				posix_fadvise(fd, 0, PREFETCH_BYTES, POSIX_FADV_WILLNEED);
+			}
+		}
+		pf->fds[pf->next % PREFETCH_DEPTH] = fd;
+		pf->next++;
+	}
+
+	int fd = pf->fds[index % PREFETCH_DEPTH];
+	if (fd == PREFETCH_DEFERRED) {
+		return fopen(pf->names[index], "r");
+	}
+
+	FILE *fp = fd >= 0 ? fdopen(fd, "r") : NULL;
+	if (fd >= 0 && fp == NULL) close(fd);
+	return fp;
+}
+
+/*
+ * Concurrent counting of many files
+ *
+ * With -j N and several FILE arguments, N worker threads take files in
+ * argument order from a shared cursor, open and count them, and mark their
+ * slot done. main() walks the slots in order and waits on each one, so
+ * output (including "cannot open" errors) appears exactly where the serial
+ * loop would print it while up to N files are being opened and read.
+ */
+struct file_job {
+	const char *name;
+	struct wc_counts stats;
+	bool failed;            // fopen() failed
+	bool done;
+};
+
+struct file_pool {
+	struct config cfg;      // Copy with jobs = 1: a worker never splits its file
+	struct file_job *jobs;
+	int count;
+	int next;               // Next job index to hand out
+	pthread_t threads[MAX_JOBS];
+	int nthreads;
+	pthread_mutex_t lock;
+	pthread_cond_t job_done;
+};
+
+static void *file_worker(void *arg) {
+	struct file_pool *pool = arg;
+
+	for (;;) {
+		pthread_mutex_lock(&pool->lock);
+		int index = pool->next < pool->count ? pool->next++ : -1;
+		pthread_mutex_unlock(&pool->lock);
+
+		if (index < 0) break;
+
+		struct file_job *job = &pool->jobs[index];
+		FILE *fp = fopen(job->name, "r");
+		if (fp == NULL) {
+			job->failed = true;
+		} else {
+			job->stats = count_file(fp, &pool->cfg);
+			fclose(fp);
+		}
+
+		pthread_mutex_lock(&pool->lock);
+		job->done = true;
+		pthread_cond_broadcast(&pool->job_done);
+		pthread_mutex_unlock(&pool->lock);
+	}
+
+	return NULL;
+}
+
+/*
+ * Start up to cfg->jobs workers over names[0..count). Returns NULL if memory
+ * is short, in which case the caller counts the files serially.
+ */
+static struct file_pool *start_file_pool(const char *const names[], int count, const struct config *cfg) {
+	struct file_pool *pool = malloc(sizeof(*pool));
+	if (pool == NULL) return NULL;
+
+	pool->jobs = calloc((size_t)count, sizeof(*pool->jobs));
+	if (pool->jobs == NULL) {
+		free(pool);
+		return NULL;
+	}
+
+	for (int i = 0; i < count; i++) {
+		pool->jobs[i].name = names[i];
+	}
+	pool->cfg = *cfg;
+	pool->cfg.jobs = 1;
+	pool->count = count;
+	pool->next = 0;
+	pool->nthreads = 0;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->job_done, NULL);
+
+	int wanted = cfg->jobs < count ? cfg->jobs : count;
+	while (pool->nthreads < wanted &&
+	       pthread_create(&pool->threads[pool->nthreads], NULL, file_worker, pool) == 0) {
+		pool->nthreads++;
+	}
+
+	// No threads at all: do the work here, the results are read back in order anyway
+	if (pool->nthreads == 0) {
+		file_worker(pool);
+	}
+
+	return pool;
+}
+
+/* Block until job index has been counted */
+static const struct file_job *wait_file_job(struct file_pool *pool, int index) {
+	struct file_job *job = &pool->jobs[index];
+
+	pthread_mutex_lock(&pool->lock);
+	while (!job->done) {
+		pthread_cond_wait(&pool->job_done, &pool->lock);
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	return job;
+}
+
+static void finish_file_pool(struct file_pool *pool) {
+	for (int t = 0; t < pool->nthreads; t++) {
+		pthread_join(pool->threads[t], NULL);
+	}
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->job_done);
+	free(pool->jobs);
+	free(pool);
+}
+
+/*
+ * compute_number_width - GNU-style column width, known before counting
+ *
+ * No count can exceed the number of bytes, so the digits of the summed
+ * sizes of all regular inputs are always enough. Inputs whose size is not
+ * known in advance (pipes, terminals, devices) force a minimum of 7, the old
+ * fixed width. A single input printing a single count needs no padding.
+ *
+ * Arguments:
+ *   names - FILE arguments, or NULL when reading standard input
+ *   count - number of names (ignored when names is NULL)
+ *
+ * Files that cannot be stat()ed are skipped; they are reported when opened.
+ */
+int compute_number_width(const char *const names[], int count, const struct config *cfg) {
+	int columns = cfg->show_lines + cfg->show_words + cfg->show_chars +
+	              cfg->show_bytes + cfg->show_max_line;
+	int inputs = names == NULL ? 1 : count;
+	int min_width = 1;
+	uintmax_t regular_total = 0;
+	int width = 1;
+
+	if (inputs == 1 && columns == 1) {
+		return 1;
+	}
+
+	for (int i = 0; i < inputs; i++) {
+		struct stat st;
+		int rc = names == NULL ? fstat(STDIN_FILENO, &st) : stat(names[i], &st);
+
+		if (rc != 0) continue;
+
+		if (!S_ISREG(st.st_mode)) {
+			min_width = 7;
+		} else if (st.st_size > 0) {
+			uintmax_t size = (uintmax_t)st.st_size;
+			regular_total = (regular_total + size < regular_total) ? UINTMAX_MAX : regular_total + size;
+		}
+	}
+
+	for (; regular_total >= 10; regular_total /= 10) {
+		width++;
+	}
+
+	return width < min_width ? min_width : width;
 }
 
 /*
  * Print stats of a single file according to configuration.
  */
-void print_stats(const struct file_stats *stats, const struct config *cfg) {
+void print_stats(const struct wc_counts *stats, const struct config *cfg) {
 	bool first = true;
 
 	if (cfg->show_lines) {
-	/*
-	* Using fixed width %7d for simplicity.
-	* Real wc uses dynamic width based on maximum counts,
-	* but that requires two-pass processing or estimation.
-	* %7d supports files up to 9,999,999 lines/words/chars.
-	*/
-		printf("%7d", stats->lines);
+		printf("%*ju", cfg->width, stats->lines);
 		first = false;
 	}
 	
 	if (cfg->show_words) {
 		if (!first) printf(" ");
-		printf("%7d", stats->words);
+		printf("%*ju", cfg->width, stats->words);
 		first = false;
 	}
 	if (cfg->show_chars) {
 		if (!first) printf(" ");
-		printf("%7d", stats->chars);
+		printf("%*ju", cfg->width, stats->chars);
+		first = false;
 	}
+	if (cfg->show_bytes) {
+		if (!first) printf(" ");
+		printf("%*ju", cfg->width, stats->bytes);
+		first = false;
+	}
+	if (cfg->show_max_line) {
+		if (!first) printf(" ");
+		printf("%*ju", cfg->width, stats->max_line);
+	}
+}
+
+/*
+ * Live follow mode (--follow FILE)
+ *
+ * The file is read to its current end, then each append is fed to the same
+ * wc_state, so only new bytes are ever read. On Linux inotify wakes us when
+ * the file is written; elsewhere (or if inotify is unavailable) the file is
+ * simply re-read every interval. Running counts are printed every interval:
+ * rewritten in place on a terminal, one line per report otherwise. SIGINT or
+ * SIGTERM ends the loop and prints the final counts.
+ *
+ * Like tail -f, the open file is followed even if it is renamed or deleted.
+ * A file that shrinks is assumed to have been truncated and is recounted.
+ */
+static volatile sig_atomic_t follow_stop = 0;
+
+static void on_follow_signal(int sig) {
+	(void)sig;
+	follow_stop = 1;
+}
+
+static double monotonic_seconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Feed whatever was appended to fd since the last call. A signal cuts the
+ * read short unless drain is set, as for the final counts, which must
+ * include everything up to end of file.
+ */
+static void follow_read(int fd, struct wc_state *st, bool drain) {
+	unsigned char buf[READ_BUFFER_SIZE];
+	ssize_t n;
+
+	while ((drain || !follow_stop) && (n = read(fd, buf, sizeof(buf))) != 0) {
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			break;  // Try again on the next wakeup
+		}
+		wc_feed(st, buf, (size_t)n);
+	}
+}
+
+static void print_follow(const struct wc_state *st, const char *name,
+                         const struct config *cfg, bool in_place) {
+	struct wc_counts stats = wc_finish(st);
+
+	if (in_place) printf("\r");
+	print_stats(&stats, cfg);
+	printf(" %s%s", name, in_place ? "\033[K" : "\n");
+	fflush(stdout);
+}
+
+static int follow_file(const char *prog_name, const char *name, const struct config *cfg) {
+	unsigned flags = cfg->show_max_line ? WC_MAX_LINE : 0;
+	bool in_place = isatty(STDOUT_FILENO);
+	int notify_fd = -1;
+	struct sigaction sa;
+	struct wc_state st;
+	struct stat sb;
+
+	int fd = open(name, O_RDONLY);
+	if (fd < 0) {
+		fprintf(stderr, "%s: cannot open '%s'\n", prog_name, name);
+		return EXIT_FAILURE;
+	}
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = on_follow_signal;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGINT, &sa, NULL);   // No SA_RESTART: poll() must return at once
+	sigaction(SIGTERM, &sa, NULL);
+
+#ifdef __linux__
+	notify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (notify_fd >= 0 && inotify_add_watch(notify_fd, name, IN_MODIFY | IN_ATTRIB) < 0) {
+		close(notify_fd);
+		notify_fd = -1;
+	}
+#endif
+
+	wc_init(&st, flags);
+	follow_read(fd, &st, false);
+	print_follow(&st, name, cfg, in_place);
+	double next_report = monotonic_seconds() + cfg->interval;
+
+	while (!follow_stop) {
+		double wait = next_report - monotonic_seconds();
+		int timeout = wait > 0 ? (int)(wait * 1000) + 1 : 0;
+
+		if (notify_fd >= 0) {
+			struct pollfd pfd = {notify_fd, POLLIN, 0};
+			if (poll(&pfd, 1, timeout) > 0) {
+				char events[4096];
+				while (read(notify_fd, events, sizeof(events)) > 0) {
+					// Drain: one read of the file covers every queued event
+				}
+			}
+		} else {
+			poll(NULL, 0, timeout);  // Plain sleep that a signal interrupts
+		}
+		if (follow_stop) break;
+
+		if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && (uintmax_t)sb.st_size < st.counts.bytes) {
+			if (in_place) printf("\n");
+			fflush(stdout);
+			fprintf(stderr, "%s: %s: file truncated\n", prog_name, name);
+			lseek(fd, 0, SEEK_SET);
+			wc_init(&st, flags);
+		}
+		follow_read(fd, &st, false);
+
+		if (monotonic_seconds() >= next_report) {
+			print_follow(&st, name, cfg, in_place);
+			next_report += cfg->interval;
+			if (next_report < monotonic_seconds()) {
+				next_report = monotonic_seconds() + cfg->interval;  // Fell behind: don't burst
+			}
+		}
+	}
+
+	// Final counts, including anything appended since the last report
+	follow_read(fd, &st, true);
+	print_follow(&st, name, cfg, in_place);
+	if (in_place) printf("\n");
+
+	if (notify_fd >= 0) close(notify_fd);
+	close(fd);
+	return EXIT_SUCCESS;
+}
+
+/*
+ * Write back and free the --cache file. A cache that cannot be saved only
+ * costs a full count next time, so this warns instead of failing the run.
+ */
+static void save_cache(const char *prog_name, const char *path, wc_cache *cache) {
+	if (cache == NULL) return;
+
+	if (wc_cache_save(cache) != 0) {
+		fflush(stdout);
+		fprintf(stderr, "%s: cannot save cache '%s': %s\n", prog_name, path, strerror(errno));
+	}
+	wc_cache_close(cache);
 }
 
 int main(int argc, const char *argv[]){
 	struct config cfg;
-	int file_start = parse_args(argc, argv, &cfg);
+	const char *cache_path;
+	int file_start = parse_args(argc, argv, &cfg, &cache_path);
+
+	wc_select_kernel(getenv("MY_WC_KERNEL"));  // Force a kernel for testing
+
+	if (cfg.follow) {
+		if (argc - file_start != 1) {
+			fprintf(stderr, "%s: --follow needs exactly one FILE\n", argv[0]);
+			fprintf(stderr, "Try '%s --help' for more information.\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+		// Counts only grow: leave room for them instead of sizing to the file now
+		cfg.width = compute_number_width(argv + file_start, 1, &cfg);
+		if (cfg.width < 7) cfg.width = 7;
+		return follow_file(argv[0], argv[file_start], &cfg);
+	}
+
+	// The files to count: FILE arguments, or the --files0-from list
+	const char *const *names = argv + file_start;
+	int count = argc - file_start;
+	char *files0_storage = NULL;
+	const char **files0_names = NULL;
+
+	if (cfg.files0_from != NULL) {
+		if (count > 0) {
+			fprintf(stderr, "%s: extra operand '%s'\n", argv[0], argv[file_start]);
+			fprintf(stderr, "file operands cannot be combined with --files0-from\n");
+			fprintf(stderr, "Try '%s --help' for more information.\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+		count = read_files0(argv[0], cfg.files0_from, &files0_storage, &files0_names);
+		names = files0_names;
+	}
+
+	if (cache_path != NULL) {
+		cfg.cache = wc_cache_open(cache_path);
+		if (cfg.cache == NULL) {
+			fprintf(stderr, "%s: out of memory loading cache '%s'\n", argv[0], cache_path);
+			return EXIT_FAILURE;
+		}
+	}
 
 	// Check if we have any files to process
-	if (file_start >= argc) {
-		struct file_stats stats = count_stream(stdin);
+	if (count == 0 && cfg.files0_from == NULL) {
+		cfg.width = compute_number_width(NULL, 0, &cfg);
+		struct wc_counts stats = count_file(stdin, &cfg);
         print_stats(&stats, &cfg);
         printf("\n");
+        save_cache(argv[0], cache_path, cfg.cache);
         return EXIT_SUCCESS;
 
 	}
     
 	// Process each file
-	struct file_stats total = {0, 0, 0};
+	struct wc_counts total = {0, 0, 0, 0, 0};
 	int file_count = 0;
+	struct file_pool *pool = NULL;
 
-	for (int i = file_start; i < argc; i++) {
-		FILE *fp = fopen(argv[i], "r");
-		if (fp == NULL) {
-			fprintf(stderr, "%s: cannot open '%s'\n", argv[0], argv[i]);
-			continue; // Skip to next file
-		}
+	struct prefetch prefetch;
+
+	cfg.width = compute_number_width(names, count, &cfg);
+
+	// Several files and -j: count them concurrently, report them in order
+	if (cfg.jobs > 1 && count > 1) {
+		pool = start_file_pool(names, count, &cfg);
+	}
+	prefetch_init(&prefetch, names, count, &cfg);  // Serial loop only
 
-		struct file_stats stats = count_stream(fp);
-		fclose(fp);
+	for (int i = 0; i < count; i++) {
+		struct wc_counts stats;
+
+		if (pool != NULL) {
+			const struct file_job *job = wait_file_job(pool, i);
+			if (job->failed) {
+				fflush(stdout);  // Keep the error at its place when both streams share a file
+				fprintf(stderr, "%s: cannot open '%s'\n", argv[0], names[i]);
+				continue;
+			}
+			stats = job->stats;
+		} else {
+			FILE *fp = prefetch_take(&prefetch, i);
+			if (fp == NULL) {
+				fflush(stdout);
+				fprintf(stderr, "%s: cannot open '%s'\n", argv[0], names[i]);
+				continue; // Skip to next file
+			}
+
+			stats = count_file(fp, &cfg);
+			fclose(fp);
+		}
 		
 		print_stats(&stats, &cfg);
-		printf(" %s\n", argv[i]); // Print filename
+		printf(" %s\n", names[i]); // Print filename
 
 		// Accumulate total
 		total.lines += stats.lines;
 		total.words += stats.words;
 		total.chars += stats.chars;
+		total.bytes += stats.bytes;
+		if (stats.max_line > total.max_line) total.max_line = stats.max_line;
 		file_count++;
 	}
 
+	if (pool != NULL) {
+		finish_file_pool(pool);
+	}
+
 	// Print total if multiple files
 	if (file_count > 1) {
 		print_stats(&total, &cfg);
 		printf(" total\n");
 	}
 
+	save_cache(argv[0], cache_path, cfg.cache);
+	free(files0_names);
+	free(files0_storage);
 	return EXIT_SUCCESS;
 }
@@ -49,7 +49,170 @@ echo ""
 echo "9. Error handling (nonexistent file):"
 ./my_wc nonexistent.txt 2>&1 | head -1
 
+echo ""
+echo "10. Counting kernels agree (scalar vs SIMD):"
+head -c 300000 /dev/urandom | tr -c 'a-z\n\t' ' ' > test3.txt
+expected=$(MY_WC_KERNEL=scalar ./my_wc test3.txt)
+for kernel in sse2 avx2 avx512; do
+    if [ "$(MY_WC_KERNEL=$kernel ./my_wc test3.txt)" = "$expected" ]; then
+        echo "  $kernel: OK"
+    else
+        echo "  $kernel: MISMATCH"
+    fi
+done
+
+echo ""
+echo "11. Parallel chunked counting (-j) matches serial:"
+head -c 5000000 /dev/urandom | tr -c 'a-z\n' ' ' > test4.txt
+expected=$(./my_wc test4.txt)
+for jobs in 2 3 8; do
+    if [ "$(./my_wc -j $jobs test4.txt)" = "$expected" ]; then
+        echo "  -j $jobs: OK"
+    else
+        echo "  -j $jobs: MISMATCH"
+    fi
+done
+# UTF-8 text with a 13-byte period: shifting it by 0..12 bytes under fixed
+# cuts puts every cut at every offset of a 2- and 3-byte character and of
+# the U+2003 and U+3000 spaces
+printf 'ab\xe3\x80\x80c\xc3\xa9d\xe2\x80\x83\n' > test8.txt
+for i in $(seq 19); do cat test8.txt test8.txt > test8.tmp; mv test8.tmp test8.txt; done
+for jobs in 2 3 8; do
+    result=OK
+    for shift in $(seq 0 12); do
+        { head -c $shift /dev/zero | tr '\0' x; cat test8.txt; } | head -c 4200000 > test9.txt
+        if [ "$(./my_wc -lwmc -j $jobs test9.txt)" != "$(./my_wc -lwmc test9.txt)" ]; then
+            result=MISMATCH
+        fi
+    done
+    echo "  -j $jobs, cuts inside UTF-8 characters: $result"
+done
+
+echo ""
+echo "12. Concurrent multi-file counting keeps argument order:"
+expected=$(./my_wc test1.txt nonexistent.txt test2.txt test4.txt 2>&1)
+if [ "$(./my_wc -j 4 test1.txt nonexistent.txt test2.txt test4.txt 2>&1)" = "$expected" ]; then
+    echo "  -j 4: OK"
+else
+    echo "  -j 4: MISMATCH"
+fi
+
+echo ""
+echo "13. Byte count from fstat (-c) matches counting a pipe:"
+if [ "$(./my_wc -c < test4.txt)" = "$(cat test4.txt | ./my_wc -c)" ]; then
+    echo "  -c: OK"
+else
+    echo "  -c: MISMATCH"
+fi
+
+echo ""
+echo "14. UTF-8 characters (-m) and max line length (-L):"
+printf 'привет мир\tx\n' > test5.txt
+if [ "$(./my_wc -lwmcL test5.txt | tr -s ' ' | sed 's/^ //')" = "1 3 13 22 17 test5.txt" ]; then
+    echo "  -lwmcL: OK"
+else
+    echo "  -lwmcL: MISMATCH"
+fi
+if [ "$(printf 'a\xe3\x80\x80b\n' | ./my_wc -w)" = "2" ]; then
+    echo "  U+3000 ideographic space separates words: OK"
+else
+    echo "  U+3000 ideographic space separates words: MISMATCH"
+fi
+
+echo ""
+echo "15. Count cache (--cache) resumes appended files, recounts changed ones:"
+check_cache() {
+    if [ "$(./my_wc -lwmcL --cache=test.cache test6.txt)" = "$(./my_wc -lwmcL test6.txt)" ]; then
+        echo "  $1: OK"
+    else
+        echo "  $1: MISMATCH"
+    fi
+}
+rm -f test.cache
+printf 'first line\nsplit wo' > test6.txt
+check_cache "first run"
+printf 'rd and a space\xe3\x80' >> test6.txt
+check_cache "append inside a word"
+printf '\x80next\n' >> test6.txt
+check_cache "append inside a character"
+printf 'FIRST LINE\nsplit word and a space\xe3\x80\x80next\n' > test6.txt
+check_cache "rewritten in place"
+printf 'short\n' > test6.txt
+check_cache "truncated"
+{ cat test4.txt; printf 'abc\xe3\x80'; } > test6.txt
+./my_wc --cache=test.cache test6.txt > /dev/null
+{ printf '\x80def '; cat test4.txt; } >> test6.txt   # Resumes mid U+3000, long enough to split
+if [ "$(./my_wc -j 4 --cache=test.cache test6.txt)" = "$(./my_wc test6.txt)" ]; then
+    echo "  -j with cache: OK"
+else
+    echo "  -j with cache: MISMATCH"
+fi
+
+echo ""
+echo "16. Follow mode (--follow) counts appends until interrupted:"
+printf 'one two\n' > test7.txt
+./my_wc --follow --interval=0.1 test7.txt > test7.out &
+follow_pid=$!
+sleep 0.3
+printf 'three four five\nsix' >> test7.txt
+sleep 0.3
+kill -INT $follow_pid
+wait $follow_pid
+if [ "$(tail -n 1 test7.out | tr -s ' ')" = "$(./my_wc test7.txt | tr -s ' ')" ]; then
+    echo "  final counts: OK"
+else
+    echo "  final counts: MISMATCH"
+fi
+# Stopped, so the append and the signal arrive together: only the final read sees it
+./my_wc --follow --interval=0.1 test7.txt > test7.out &
+follow_pid=$!
+sleep 0.3
+kill -STOP $follow_pid
+printf ' seven eight\n' >> test7.txt
+kill -INT $follow_pid
+kill -CONT $follow_pid
+wait $follow_pid
+if [ "$(tail -n 1 test7.out | tr -s ' ')" = "$(./my_wc test7.txt | tr -s ' ')" ]; then
+    echo "  append just before the signal: OK"
+else
+    echo "  append just before the signal: MISMATCH"
+fi
+
+echo ""
+echo "17. File list from --files0-from matches FILE arguments:"
+printf 'test1.txt\0test2.txt\0nonexistent.txt\0test5.txt' > test.list
+expected=$(./my_wc test1.txt test2.txt nonexistent.txt test5.txt 2>&1)
+if [ "$(./my_wc --files0-from=test.list 2>&1)" = "$expected" ]; then
+    echo "  list file: OK"
+else
+    echo "  list file: MISMATCH"
+fi
+if [ "$(./my_wc --files0-from=- < test.list 2>&1)" = "$expected" ]; then
+    echo "  list on stdin: OK"
+else
+    echo "  list on stdin: MISMATCH"
+fi
+if printf 'test1.txt\0-\0' | ./my_wc --files0-from=- 2>&1 | grep -q "no file name of '-' allowed"; then
+    echo "  '-' in a list on stdin rejected: OK"
+else
+    echo "  '-' in a list on stdin rejected: MISMATCH"
+fi
+# A FIFO further down the list must not hold up the files before it
+rm -f test.fifo
+mkfifo test.fifo
+printf 'test1.txt\0test.fifo\0' > test.list
+stdbuf -oL ./my_wc --files0-from=test.list > test7.out &
+list_pid=$!
+sleep 0.3
+if grep -q 'test1.txt' test7.out; then
+    echo "  FIFO in the list opened when reached: OK"
+else
+    echo "  FIFO in the list opened when reached: MISMATCH"
+fi
+printf 'a b\n' > test.fifo
+wait $list_pid
+
 # Cleanup
-rm -f test1.txt test2.txt
+rm -f test1.txt test2.txt test3.txt test4.txt test5.txt test6.txt test7.txt test8.txt test9.txt test7.out test.cache test.list test.fifo
 echo ""
 echo "=== All tests completed ==="
\ No newline at end of file
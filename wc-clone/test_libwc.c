@@ -0,0 +1,197 @@
+#include "libwc.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+// Helper to track test results
+static int tests_passed = 0;
+
+#define RUN_TEST(test_func) do { \
+    printf("Testing %-25s ... ", #test_func); \
+    test_func(); \
+    printf("PASS\n"); \
+    tests_passed++; \
+} while(0)
+
+static const char sample[] =
+    "hello world\n"
+    "  tabs\tand  spaces \n"
+    "привет мир\xe3\x80\x80слово\n"   // U+3000 ideographic space between words
+    "em\xe2\x80\x83" "space, em\xe2\x80\x94" "dash\n"  // U+2003 separates, U+2014 does not
+    "no newline at end";
+
+static struct wc_counts count_all(const char *buf, size_t len, unsigned flags) {
+    struct wc_state st;
+    wc_init(&st, flags);
+    wc_feed(&st, buf, len);
+    return wc_finish(&st);
+}
+
+static bool counts_equal(struct wc_counts a, struct wc_counts b) {
+    return a.lines == b.lines && a.words == b.words && a.chars == b.chars &&
+           a.bytes == b.bytes && a.max_line == b.max_line;
+}
+
+// ==================== Test Cases ====================
+
+static void test_empty() {
+    struct wc_counts c = count_all("", 0, WC_MAX_LINE);
+    assert(c.lines == 0 && c.words == 0 && c.chars == 0 && c.bytes == 0 && c.max_line == 0);
+}
+
+static void test_basic_counts() {
+    struct wc_counts c = count_all(sample, strlen(sample), WC_MAX_LINE);
+    assert(c.lines == 5);   // Four newlines plus the unterminated last line
+    assert(c.words == 15);
+    assert(c.bytes == strlen(sample));
+    assert(c.chars == c.bytes - 20);  // 14 two-byte Cyrillic letters, 3 three-byte characters
+    assert(c.max_line == 20); // "  tabs\tand  spaces " is 20 columns wide
+}
+
+static void test_split_feeds() {
+    // Feeding any split, including inside multibyte sequences, gives the same counts
+    size_t len = strlen(sample);
+    struct wc_counts whole = count_all(sample, len, WC_MAX_LINE);
+
+    for (size_t cut = 0; cut <= len; cut++) {
+        struct wc_state st;
+        wc_init(&st, WC_MAX_LINE);
+        wc_feed(&st, sample, cut);
+        wc_feed(&st, sample + cut, len - cut);
+        assert(counts_equal(wc_finish(&st), whole));
+    }
+
+    struct wc_state st;
+    wc_init(&st, WC_MAX_LINE);
+    for (size_t i = 0; i < len; i++) {
+        wc_feed(&st, sample + i, 1);
+    }
+    assert(counts_equal(wc_finish(&st), whole));
+}
+
+static void test_finish_is_repeatable() {
+    struct wc_state st;
+    wc_init(&st, 0);
+    wc_feed(&st, "one two", 7);
+    struct wc_counts first = wc_finish(&st);
+    assert(first.words == 2 && first.lines == 1);
+
+    // Feeding may continue after wc_finish()
+    wc_feed(&st, "three\n", 6);
+    struct wc_counts second = wc_finish(&st);
+    assert(second.words == 2);  // "twothree" is one word
+    assert(second.lines == 1);
+    assert(second.bytes == 13);
+}
+
+static void test_merge() {
+    size_t len = strlen(sample);
+    struct wc_counts whole = count_all(sample, len, 0);
+
+    for (size_t cut = 0; cut <= len; cut++) {
+        if ((sample[cut] & 0xC0) == 0x80) continue;  // Cuts must be on character boundaries
+
+        struct wc_state left, right;
+        wc_init(&left, 0);
+        wc_init(&right, 0);
+        wc_feed(&left, sample, cut);
+        wc_feed(&right, sample + cut, len - cut);
+        wc_merge(&left, &right);
+        assert(counts_equal(wc_finish(&left), whole));
+    }
+}
+
+static void test_state_roundtrip() {
+    // Saving and restoring the state at any cut resumes exactly
+    size_t len = strlen(sample);
+    struct wc_counts whole = count_all(sample, len, WC_MAX_LINE);
+
+    for (size_t cut = 0; cut <= len; cut++) {
+        struct wc_state st, restored;
+        char text[WC_STATE_TEXT_MAX];
+
+        wc_init(&st, WC_MAX_LINE);
+        wc_feed(&st, sample, cut);
+        assert(wc_state_format(&st, text, sizeof(text)) < (int)sizeof(text));
+        assert(wc_state_parse(&restored, text));
+
+        wc_feed(&restored, sample + cut, len - cut);
+        assert(counts_equal(wc_finish(&restored), whole));
+    }
+
+    struct wc_state st;
+    assert(!wc_state_parse(&st, ""));
+    assert(!wc_state_parse(&st, "wc0 1 2 3 4 5"));
+}
+
+/* Every kernel must match the scalar one, with and without max-line tracking */
+static void check_kernels(const char *buf, size_t len) {
+    const char *kernels[] = {"scalar", "sse2", "avx2", "avx512"};
+    const unsigned flags[] = {0, WC_MAX_LINE};
+
+    for (size_t f = 0; f < sizeof(flags) / sizeof(flags[0]); f++) {
+        wc_select_kernel("scalar");
+        struct wc_counts expected = count_all(buf, len, flags[f]);
+
+        for (size_t k = 1; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+            wc_select_kernel(kernels[k]);
+            assert(counts_equal(count_all(buf, len, flags[f]), expected));
+        }
+    }
+    wc_select_kernel(NULL);
+}
+
+/*
+ * Fill buf with pieces picked at random; each of the first ascii_pieces is
+ * picked ascii_weight times as often as each of the rest.
+ */
+static size_t build_corpus(char *buf, size_t size, const char *const pieces[], size_t npieces,
+                           size_t ascii_pieces, unsigned ascii_weight) {
+    unsigned seed = 12345;
+    size_t slots = ascii_pieces * ascii_weight + (npieces - ascii_pieces);
+    size_t len = 0;
+
+    while (len + 4 < size) {
+        seed = seed * 1103515245u + 12345u;
+        size_t slot = (seed >> 16) % slots;
+        const char *p = slot < ascii_pieces * ascii_weight ? pieces[slot / ascii_weight]
+                                                           : pieces[ascii_pieces + slot - ascii_pieces * ascii_weight];
+        memcpy(buf + len, p, strlen(p));
+        len += strlen(p);
+    }
+    return len;
+}
+
+static void test_kernels_agree() {
+    static char buf[70000];
+    const char *pieces[] = {"a", "b", " ", "\t", "\n", "\r", "\x01",
+                            "\xc3\xa9", "\xe2\x80\x83", "\xe2\x80\x94", "\xe3\x80\x80"};
+    size_t npieces = sizeof(pieces) / sizeof(pieces[0]);
+
+    // Dense multibyte text: every vector takes the slow path
+    check_kernels(buf, build_corpus(buf, sizeof(buf), pieces, npieces, npieces, 1));
+
+    // Mostly ASCII with a rare multibyte character: the fast path covers whole
+    // vectors, and the few that hold a lead byte fall back mid-buffer
+    check_kernels(buf, build_corpus(buf, sizeof(buf), pieces, npieces, 7, 300));
+}
+
+int main() {
+    printf("========================================\n");
+    printf("       libwc Test Suite (kernel: %s)\n", wc_select_kernel(NULL));
+    printf("========================================\n\n");
+
+    RUN_TEST(test_empty);
+    RUN_TEST(test_basic_counts);
+    RUN_TEST(test_split_feeds);
+    RUN_TEST(test_finish_is_repeatable);
+    RUN_TEST(test_merge);
+    RUN_TEST(test_state_roundtrip);
+    RUN_TEST(test_kernels_agree);
+
+    printf("\n========================================\n");
+    printf("All %d tests passed!\n", tests_passed);
+    printf("========================================\n");
+
+    return 0;
+}
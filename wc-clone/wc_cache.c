@@ -0,0 +1,280 @@
+#define _POSIX_C_SOURCE 200809L // for getline(), pread() and pthreads
+#include "wc_cache.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CACHE_MAGIC "my_wc-cache 1"
+#define FINGERPRINT_BYTES 256   // Bytes before the cached offset that must be unchanged
+
+struct cache_entry {
+	uintmax_t dev;
+	uintmax_t ino;
+	uint64_t fingerprint;
+	struct wc_state st;         // st.counts.bytes is the offset counted up to
+	size_t order;               // Updates only: store order, so the last store of a file wins
+};
+
+struct wc_cache {
+	char *path;
+	struct cache_entry *entries;    // Loaded entries, sorted by (dev, ino), read-only until save
+	size_t count;
+	struct cache_entry *updates;    // Stored during this run, merged in by wc_cache_save()
+	size_t update_count;
+	size_t update_capacity;
+	pthread_mutex_t lock;           // Protects updates
+};
+
+
+// Helper functions
+static int compare_entries(const void *a, const void *b) {
+	const struct cache_entry *x = a;
+	const struct cache_entry *y = b;
+
+	if (x->dev != y->dev) return x->dev < y->dev ? -1 : 1;
+	if (x->ino != y->ino) return x->ino < y->ino ? -1 : 1;
+	return 0;
+}
+
+/* Updates by (dev, ino), repeated stores of one file in store order */
+static int compare_updates(const void *a, const void *b) {
+	const struct cache_entry *x = a;
+	const struct cache_entry *y = b;
+	int cmp = compare_entries(a, b);
+
+	if (cmp != 0) return cmp;
+	return x->order < y->order ? -1 : x->order > y->order;
+}
+
+static struct cache_entry *find_entry(const wc_cache *cache, uintmax_t dev, uintmax_t ino) {
+	struct cache_entry key;
+	key.dev = dev;
+	key.ino = ino;
+
+	if (cache->count == 0) return NULL;
+	return bsearch(&key, cache->entries, cache->count, sizeof(key), compare_entries);
+}
+
+/*
+ * FNV-1a hash of the FINGERPRINT_BYTES bytes before offset. A file that
+ * was only appended to still has these bytes; one rewritten in place
+ * (or truncated and regrown past offset) almost certainly does not.
+ */
+static bool fingerprint(int fd, uintmax_t offset, uint64_t *out) {
+	unsigned char buf[FINGERPRINT_BYTES];
+	size_t want = offset < sizeof(buf) ? (size_t)offset : sizeof(buf);
+	size_t got = 0;
+	uint64_t hash = 14695981039346656037ULL;
+
+	while (got < want) {
+		ssize_t n = pread(fd, buf + got, want - got, (off_t)(offset - want + got));
+		if (n < 0 && errno == EINTR) continue;
+		if (n <= 0) return false;
+		got += (size_t)n;
+	}
+
+	for (size_t i = 0; i < want; i++) {
+		hash = (hash ^ buf[i]) * 1099511628211ULL;
+	}
+
+	*out = hash;
+	return true;
+}
+
+static bool append_entry(struct cache_entry **array, size_t *count, size_t *capacity,
+                         const struct cache_entry *entry) {
+	if (*count == *capacity) {
+		size_t new_cap = *capacity == 0 ? 64 : *capacity * 2;
+		struct cache_entry *grown = realloc(*array, new_cap * sizeof(**array));
+		if (grown == NULL) return false;
+		*array = grown;
+		*capacity = new_cap;
+	}
+
+	(*array)[(*count)++] = *entry;
+	return true;
+}
+
+/* Parse "dev ino fingerprint <wc_state text>"; false for malformed lines */
+static bool parse_entry(const char *line, struct cache_entry *entry) {
+	int consumed = 0;
+
+	if (sscanf(line, "%ju %ju %" SCNx64 " %n", &entry->dev, &entry->ino,
+	           &entry->fingerprint, &consumed) != 3 || consumed == 0) {
+		return false;
+	}
+
+	return wc_state_parse(&entry->st, line + consumed);
+}
+
+
+// Public API
+wc_cache *wc_cache_open(const char *path) {
+	wc_cache *cache = calloc(1, sizeof(*cache));
+	if (cache == NULL) return NULL;
+
+	cache->path = malloc(strlen(path) + 1);
+	if (cache->path == NULL) {
+		free(cache);
+		return NULL;
+	}
+	strcpy(cache->path, path);
+	pthread_mutex_init(&cache->lock, NULL);
+
+	FILE *fp = fopen(path, "r");
+	if (fp == NULL) {
+		return cache;  // First run: nothing cached yet
+	}
+
+	char *line = NULL;
+	size_t line_cap = 0;
+	size_t capacity = 0;
+
+	if (getline(&line, &line_cap, fp) > 0 && strncmp(line, CACHE_MAGIC, strlen(CACHE_MAGIC)) == 0) {
+		while (getline(&line, &line_cap, fp) > 0) {
+			struct cache_entry entry;
+			if (parse_entry(line, &entry) &&
+			    !append_entry(&cache->entries, &cache->count, &capacity, &entry)) {
+				break;  // Out of memory: keep what fits, the rest is recounted
+			}
+		}
+	}
+
+	free(line);
+	fclose(fp);
+
+	qsort(cache->entries, cache->count, sizeof(*cache->entries), compare_entries);
+	return cache;
+}
+
+bool wc_cache_lookup(const wc_cache *cache, const struct stat *sb, int fd,
+                     unsigned flags, struct wc_state *st) {
+	const struct cache_entry *entry = find_entry(cache, (uintmax_t)sb->st_dev, (uintmax_t)sb->st_ino);
+	uint64_t current;
+
+	if (entry == NULL) return false;
+
+	uintmax_t offset = entry->st.counts.bytes;
+
+	if ((uintmax_t)sb->st_size < offset) return false;                        // Truncated
+	if ((flags & WC_MAX_LINE) && !entry->st.track_max_line) return false;     // -L was not tracked
+	if (!fingerprint(fd, offset, &current) || current != entry->fingerprint) return false;  // Rewritten
+
+	*st = entry->st;
+	return true;
+}
+
+void wc_cache_store(wc_cache *cache, const struct stat *sb, int fd, const struct wc_state *st) {
+	struct cache_entry entry;
+
+	entry.dev = (uintmax_t)sb->st_dev;
+	entry.ino = (uintmax_t)sb->st_ino;
+	entry.st = *st;
+	if (!fingerprint(fd, st->counts.bytes, &entry.fingerprint)) {
+		return;  // Unreadable now: better not to cache at all
+	}
+
+	pthread_mutex_lock(&cache->lock);
+	entry.order = cache->update_count;
+	append_entry(&cache->updates, &cache->update_count, &cache->update_capacity, &entry);
+	pthread_mutex_unlock(&cache->lock);
+}
+
+/*
+ * Merge the updates into the sorted entries in one pass: sort the updates,
+ * keep the last store of each file, and walk both arrays side by side. An
+ * updated file replaces its old entry, a new file is inserted in order.
+ */
+static bool merge_updates(wc_cache *cache) {
+	struct cache_entry *merged = malloc((cache->count + cache->update_count) * sizeof(*merged));
+	size_t n = 0, i = 0, u = 0;
+
+	if (merged == NULL) return false;
+
+	qsort(cache->updates, cache->update_count, sizeof(*cache->updates), compare_updates);
+
+	while (u < cache->update_count) {
+		const struct cache_entry *update = &cache->updates[u++];
+
+		while (u < cache->update_count && compare_entries(update, &cache->updates[u]) == 0) {
+			update = &cache->updates[u++];   // A later store of the same file
+		}
+		while (i < cache->count && compare_entries(&cache->entries[i], update) < 0) {
+			merged[n++] = cache->entries[i++];
+		}
+		if (i < cache->count && compare_entries(&cache->entries[i], update) == 0) {
+			i++;                             // Replaced
+		}
+		merged[n++] = *update;
+	}
+	while (i < cache->count) {
+		merged[n++] = cache->entries[i++];
+	}
+
+	free(cache->entries);
+	cache->entries = merged;
+	cache->count = n;
+	cache->update_count = 0;
+	return true;
+}
+
+int wc_cache_save(wc_cache *cache) {
+	if (cache->update_count == 0) return 0;
+
+	if (!merge_updates(cache)) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	size_t tmp_len = strlen(cache->path) + sizeof(".tmp");
+	char *tmp_path = malloc(tmp_len);
+	if (tmp_path == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+	snprintf(tmp_path, tmp_len, "%s.tmp", cache->path);
+
+	FILE *fp = fopen(tmp_path, "w");
+	if (fp == NULL) {
+		free(tmp_path);
+		return -1;
+	}
+
+	fprintf(fp, "%s\n", CACHE_MAGIC);
+	for (size_t i = 0; i < cache->count; i++) {
+		const struct cache_entry *entry = &cache->entries[i];
+		char state[WC_STATE_TEXT_MAX];
+
+		wc_state_format(&entry->st, state, sizeof(state));
+		fprintf(fp, "%ju %ju %016" PRIx64 " %s\n", entry->dev, entry->ino, entry->fingerprint, state);
+	}
+
+	int saved_errno = 0;
+	if (ferror(fp)) saved_errno = EIO;
+	if (fclose(fp) != 0 && saved_errno == 0) saved_errno = errno;
+	if (saved_errno == 0 && rename(tmp_path, cache->path) != 0) saved_errno = errno;
+
+	if (saved_errno != 0) {
+		unlink(tmp_path);
+		free(tmp_path);
+		errno = saved_errno;
+		return -1;
+	}
+
+	free(tmp_path);
+	return 0;
+}
+
+void wc_cache_close(wc_cache *cache) {
+	if (cache == NULL) return;
+
+	pthread_mutex_destroy(&cache->lock);
+	free(cache->entries);
+	free(cache->updates);
+	free(cache->path);
+	free(cache);
+}
@@ -0,0 +1,36 @@
+#ifndef WC_CACHE_H
+#define WC_CACHE_H
+
+#include <stdbool.h>
+#include <sys/stat.h>
+#include "libwc.h"
+
+/*
+ * wc_cache - Incremental count cache for append-only files (--cache=FILE)
+ *
+ * For every counted file the cache remembers, keyed by device and inode:
+ * - the size counted so far
+ * - a fingerprint of the bytes just before that offset
+ * - the full libwc state at that offset (counts plus word boundary state)
+ *
+ * On the next run a file that only grew resumes from the cached state and
+ * only the appended tail is read. A file that shrank, whose fingerprint no
+ * longer matches (rewritten in place) or that was replaced (new inode)
+ * is counted from scratch.
+ *
+ * The cache is loaded once, lookups are read-only and stores are locked,
+ * so worker threads may share one cache. Changes are written back by
+ * wc_cache_save(), atomically via a temporary file and rename().
+ */
+
+typedef struct wc_cache wc_cache;
+
+wc_cache *wc_cache_open(const char *path);       // Load path (a missing or unreadable file gives an empty cache); NULL on out of memory
+bool wc_cache_lookup(const wc_cache *cache, const struct stat *sb, int fd,
+                     unsigned flags, struct wc_state *st);  // Cached state to resume fd from; false if it must be counted from scratch
+void wc_cache_store(wc_cache *cache, const struct stat *sb, int fd,
+                    const struct wc_state *st);              // Remember st as the state after st->counts.bytes bytes of fd
+int wc_cache_save(wc_cache *cache);              // Write the cache back; 0 on success, -1 with errno set
+void wc_cache_close(wc_cache *cache);            // Free the cache (does not save)
+
+#endif /* WC_CACHE_H */